@@ -0,0 +1,215 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @brief Autómata de Aho–Corasick para contar apariciones de muchas palabras en una sola pasada.
+ * Ignora mayúsculas/minúsculas y solo cuenta palabras completas: el carácter anterior y el
+ * siguiente a la coincidencia no pueden ser letras, dígitos ni bytes UTF-8.
+ * Las transiciones se guardan como tabla densa sobre el alfabeto de las palabras cargadas,
+ * así que el recorrido cuesta una consulta por byte sin importar cuántas palabras haya.
+ */
+class AhoCorasick {
+public:
+    /**
+     * @brief Resultado de recorrer un texto.
+     */
+    struct MatchSummary {
+        size_t matches = 0;
+        size_t matchedLetters = 0;
+    };
+
+    AhoCorasick() {
+        reset();
+    }
+
+    explicit AhoCorasick(const std::vector<std::string>& words) {
+        build(words);
+    }
+
+    ~AhoCorasick() = default;
+
+    /**
+     * @brief Construye el autómata a partir de una lista de palabras.
+     * @param words Las palabras a buscar (se pasan a minúsculas; las vacías se ignoran).
+     */
+    void
+    build(const std::vector<std::string>& words) {
+        reset();
+        for (const auto& word : words) {
+            for (unsigned char c : word) {
+                unsigned char lower = fold(c);
+                if (symbol_[lower] == 0) {
+                    symbol_[lower] = static_cast<uint16_t>(++alphabet_size_);
+                }
+            }
+        }
+        columns_ = alphabet_size_ + 1;
+        transitions_.assign(columns_, 0);
+        output_length_.assign(1, 0);
+        fail_.assign(1, 0);
+        word_count_ = 0;
+
+        // Trie con las palabras.
+        for (const auto& word : words) {
+            if (word.empty()) {
+                continue;
+            }
+            uint32_t state = 0;
+            for (unsigned char c : word) {
+                size_t slot = state * columns_ + symbol_[fold(c)];
+                if (transitions_[slot] == 0) {
+                    uint32_t created = addState();
+                    transitions_[slot] = created;
+                }
+                state = transitions_[slot];
+            }
+            if (output_length_[state] == 0) {
+                ++word_count_;
+            }
+            output_length_[state] = static_cast<uint32_t>(word.size());
+        }
+
+        // Enlaces de fallo por anchura; las transiciones ausentes se completan (autómata determinista).
+        std::vector<uint32_t> queue;
+        for (size_t sym = 1; sym < columns_; ++sym) {
+            uint32_t next = transitions_[sym];
+            if (next != 0) {
+                fail_[next] = 0;
+                queue.push_back(next);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t state = queue[head];
+            dictionary_link_.resize(fail_.size(), 0);
+            uint32_t fallback = fail_[state];
+            dictionary_link_[state] = output_length_[fallback] != 0 ? fallback : dictionary_link_[fallback];
+            for (size_t sym = 1; sym < columns_; ++sym) {
+                uint32_t& next = transitions_[state * columns_ + sym];
+                if (next != 0) {
+                    fail_[next] = transitions_[fallback * columns_ + sym];
+                    queue.push_back(next);
+                } else {
+                    next = transitions_[fallback * columns_ + sym];
+                }
+            }
+        }
+        dictionary_link_.resize(fail_.size(), 0);
+    }
+
+    /**
+     * @brief Carga las palabras desde un archivo (una por línea) y construye el autómata.
+     * @param filepath Ruta al archivo de palabras.
+     * @return true si el archivo se pudo leer y contenía al menos una palabra.
+     */
+    bool
+    loadFromFile(const std::string& filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::vector<std::string> words;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (words.empty() && line.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+                line.erase(0, 3);
+            }
+            line.erase(0, line.find_first_not_of(" \t\n\r\f\v"));
+            line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+            if (!line.empty() && line[0] != '#') {
+                words.push_back(line);
+            }
+        }
+        if (words.empty()) {
+            return false;
+        }
+        build(words);
+        return true;
+    }
+
+    /**
+     * @brief Cuenta las palabras completas que aparecen en el texto, en una sola pasada.
+     * @param data El texto.
+     * @param length Longitud del texto en bytes.
+     * @return Número de coincidencias y número total de letras cubiertas por ellas.
+     */
+    MatchSummary
+    scan(const char* data, size_t length) const {
+        MatchSummary summary;
+        uint32_t state = 0;
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            state = transitions_[state * columns_ + symbol_[fold(c)]];
+            if (state == 0) {
+                continue;
+            }
+            // Solo interesa si la palabra termina en un límite.
+            if (i + 1 < length && isWordByte(static_cast<unsigned char>(data[i + 1]))) {
+                continue;
+            }
+            for (uint32_t match = output_length_[state] != 0 ? state : dictionary_link_[state]; match != 0;
+                 match = dictionary_link_[match]) {
+                size_t word_length = output_length_[match];
+                size_t start = i + 1 - word_length;
+                if (start == 0 || !isWordByte(static_cast<unsigned char>(data[start - 1]))) {
+                    ++summary.matches;
+                    summary.matchedLetters += word_length;
+                }
+            }
+        }
+        return summary;
+    }
+
+    MatchSummary
+    scan(const std::string& text) const {
+        return scan(text.data(), text.size());
+    }
+
+    /**
+     * @brief Número de palabras distintas del autómata.
+     */
+    size_t
+    size() const {
+        return word_count_;
+    }
+
+private:
+    static unsigned char
+    fold(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+    }
+
+    static bool
+    isWordByte(unsigned char c) {
+        return std::isalnum(c) || c >= 0x80;
+    }
+
+    uint32_t
+    addState() {
+        transitions_.resize(transitions_.size() + columns_, 0);
+        output_length_.push_back(0);
+        fail_.push_back(0);
+        return static_cast<uint32_t>(output_length_.size() - 1);
+    }
+
+    void
+    reset() {
+        symbol_.fill(0);
+        alphabet_size_ = 0;
+        columns_ = 1;
+        transitions_.assign(1, 0);
+        output_length_.assign(1, 0);
+        fail_.assign(1, 0);
+        dictionary_link_.assign(1, 0);
+        word_count_ = 0;
+    }
+
+    // Símbolo de cada byte (0 = fuera del alfabeto, vuelve a la raíz).
+    std::array<uint16_t, 256> symbol_{};
+    size_t alphabet_size_ = 0;
+    size_t columns_ = 1;
+    std::vector<uint32_t> transitions_;
+    std::vector<uint32_t> output_length_;
+    std::vector<uint32_t> fail_;
+    std::vector<uint32_t> dictionary_link_;
+    size_t word_count_ = 0;
+};
@@ -0,0 +1,479 @@
+#pragma once
+#include "CircuitBreaker.h"
+#include "HttpRequestPool.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Estado de un servidor del balanceador.
+ */
+struct BackendStatus {
+    std::string baseUrl;
+    size_t outstanding = 0;
+    double averageSeconds = 0.0;  // media móvil de la duración de las respuestas
+    bool healthy = true;
+    bool ejected = false;
+    bool circuitOpen = false;
+};
+
+/**
+ * @brief Reparte peticiones entre varios servidores equivalentes (p. ej. varios procesos del modelo
+ * en puertos distintos). Cada servidor tiene su propio HttpRequestPool y su cortacircuitos, y cada
+ * petición va al servidor disponible con menos peticiones pendientes.
+ * Con más de un servidor, un hilo comprueba periódicamente la salud de cada uno (GET a 'health_path')
+ * y los servidores cuya latencia media supera varias veces la mediana de los demás se expulsan
+ * temporalmente. Nunca se deja sin servidores disponibles por lentitud.
+ * submitHedged añade peticiones de cobertura: si la respuesta tarda más que el percentil 95 observado,
+ * se envía una copia a otro servidor y gana la primera respuesta.
+ */
+class BalancedRequestPool {
+public:
+    using Callback = HttpRequestPool::Callback;
+    using Clock = HttpRequestPool::Clock;
+
+    /**
+     * @param base_urls URLs base de los servidores.
+     * @param connections_per_backend Conexiones keep-alive hacia cada servidor.
+     * @param health_path Ruta que se consulta con GET para comprobar la salud.
+     * @throws std::runtime_error Si la lista está vacía o alguna URL no es válida.
+     */
+    BalancedRequestPool(const std::vector<std::string>& base_urls, size_t connections_per_backend = 4,
+                        const std::string& health_path = "/") :
+        health_path_(health_path) {
+        if (base_urls.empty()) {
+            throw std::runtime_error("Error: no se indicó ningún servidor de la API.");
+        }
+        for (const auto& url : base_urls) {
+            auto backend = std::make_unique<Backend>();
+            backend->baseUrl = url;
+            backend->breaker = CircuitBreaker::forServer(url);
+            backend->pool = std::make_unique<HttpRequestPool>(url, connections_per_backend, backend->breaker);
+            backends_.push_back(std::move(backend));
+        }
+    }
+
+    ~BalancedRequestPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        stop_signal_.notify_all();
+        hedge_ready_.notify_all();
+        if (health_thread_.joinable()) {
+            health_thread_.join();
+        }
+        if (hedge_thread_.joinable()) {
+            hedge_thread_.join();
+        }
+        // Los grupos se cierran primero: sus últimos callbacks todavía usan el estado del balanceador.
+        for (auto& backend : backends_) {
+            backend->pool.reset();
+        }
+    }
+
+    BalancedRequestPool(const BalancedRequestPool&) = delete;
+    BalancedRequestPool& operator=(const BalancedRequestPool&) = delete;
+
+    /**
+     * @brief Encola un POST en el servidor elegido; 'callback' se llama desde un hilo de su grupo.
+     */
+    void
+    submit(const std::string& path, std::string body, const std::string& content_type, Callback callback,
+           Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "") {
+        Backend& backend = choose();
+        const Clock::time_point submitted = Clock::now();
+        backend.pool->submit(path, std::move(body), content_type,
+                             [this, &backend, path, submitted, callback = std::move(callback)](HttpReply reply) {
+                                 recordReply(backend, path, reply, submitted);
+                                 callback(std::move(reply));
+                             }, deadline, accept);
+    }
+
+    /**
+     * @brief Como submit, pero con cobertura: si no hay respuesta cuando se cumple el percentil 95 de la
+     * latencia observada en 'path', se envía una copia a otro servidor (o por otra conexión si solo hay uno).
+     * Gana la primera respuesta correcta; la otra copia se cancela si aún no salió de la cola y, si ya
+     * salió, su respuesta se descarta. Las copias no superan HEDGE_BUDGET de las peticiones enviadas.
+     * Solo debe usarse con peticiones idempotentes.
+     */
+    void
+    submitHedged(const std::string& path, std::string body, const std::string& content_type, Callback callback,
+                 Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "") {
+        std::optional<Clock::duration> delay = hedgeDelay(path);
+        if (!delay) {
+            submit(path, std::move(body), content_type, std::move(callback), deadline, accept);
+            return;
+        }
+        auto hedge = std::make_shared<Hedge>();
+        hedge->path = path;
+        hedge->body = body;
+        hedge->contentType = content_type;
+        hedge->accept = accept;
+        hedge->deadline = deadline;
+        hedge->callback = std::move(callback);
+        hedge->primaryCancel = std::make_shared<std::atomic<bool>>(false);
+        hedge->hedgeCancel = std::make_shared<std::atomic<bool>>(false);
+
+        Backend& backend = choose();
+        hedge->primary = &backend;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!hedge_thread_.joinable()) {
+                hedge_thread_ = std::thread([this]() { hedgeLoop(); });
+            }
+            hedge_timers_.emplace(hedge->submitted + *delay, hedge);
+        }
+        hedge_ready_.notify_one();
+        backend.pool->submit(path, std::move(body), content_type,
+                             [this, &backend, hedge](HttpReply reply) {
+                                 recordReply(backend, hedge->path, reply, hedge->submitted);
+                                 finishHedge(*hedge, std::move(reply), false);
+                             }, deadline, accept, hedge->primaryCancel);
+    }
+
+    std::future<HttpReply>
+    submit(const std::string& path, std::string body, const std::string& content_type,
+           Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "") {
+        auto promise = std::make_shared<std::promise<HttpReply>>();
+        std::future<HttpReply> future = promise->get_future();
+        submit(path, std::move(body), content_type,
+               [promise](HttpReply reply) { promise->set_value(std::move(reply)); }, deadline, accept);
+        return future;
+    }
+
+    HttpReply
+    post(const std::string& path, std::string body, const std::string& content_type,
+         Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "") {
+        return submit(path, std::move(body), content_type, deadline, accept).get();
+    }
+
+    /**
+     * @brief true si al menos un servidor puede recibir peticiones (circuito cerrado o listo para sondear).
+     */
+    bool
+    available() const {
+        for (const auto& backend : backends_) {
+            if (!backend->breaker->isOpen()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Número de servidores disponibles ahora mismo (sanos, no expulsados y con el circuito cerrado).
+     */
+    size_t
+    activeCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (const auto& backend : backends_) {
+            count += isActive(*backend, Clock::now()) ? 1 : 0;
+        }
+        return count;
+    }
+
+    size_t
+    size() const {
+        return backends_.size();
+    }
+
+    /**
+     * @brief Peticiones enviadas (sin contar las copias de cobertura).
+     */
+    uint64_t
+    requestsSent() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    /**
+     * @brief Copias de cobertura enviadas.
+     */
+    uint64_t
+    hedgesSent() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hedges_;
+    }
+
+    std::vector<BackendStatus>
+    status() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<BackendStatus> result;
+        for (const auto& backend : backends_) {
+            BackendStatus entry;
+            entry.baseUrl = backend->baseUrl;
+            entry.outstanding = backend->pool->outstanding();
+            entry.averageSeconds = backend->averageSeconds;
+            entry.healthy = backend->healthy;
+            entry.ejected = Clock::now() < backend->ejectedUntil;
+            entry.circuitOpen = backend->breaker->isOpen();
+            result.push_back(entry);
+        }
+        return result;
+    }
+
+private:
+    // Respuestas necesarias antes de juzgar la latencia de un servidor.
+    static constexpr uint64_t MIN_SAMPLES = 5;
+    // Un servidor se expulsa si su media supera este múltiplo de la mediana de los demás...
+    static constexpr double EJECTION_FACTOR = 3.0;
+    // ...y además esta latencia absoluta, para no expulsar por diferencias de milisegundos.
+    static constexpr double EJECTION_MIN_SECONDS = 0.05;
+    static constexpr std::chrono::seconds EJECTION_TIME{15};
+    static constexpr std::chrono::seconds HEALTH_INTERVAL{2};
+    static constexpr double LATENCY_SMOOTHING = 0.2;
+    // Latencias recientes por ruta con las que se calcula el percentil de cobertura.
+    static constexpr size_t LATENCY_WINDOW = 256;
+    static constexpr size_t HEDGE_MIN_SAMPLES = 20;
+    static constexpr double HEDGE_PERCENTILE = 0.95;
+    static constexpr std::chrono::milliseconds HEDGE_MIN_DELAY{5};
+    // Fracción máxima de copias de cobertura respecto a las peticiones.
+    static constexpr double HEDGE_BUDGET = 0.1;
+
+    struct Backend {
+        std::string baseUrl;
+        std::shared_ptr<CircuitBreaker> breaker;
+        std::unique_ptr<HttpRequestPool> pool;
+        double averageSeconds = 0.0;
+        uint64_t samples = 0;
+        bool healthy = true;
+        Clock::time_point ejectedUntil{};
+    };
+
+    /**
+     * @brief Petición con cobertura: la original y, si llega a enviarse, su copia.
+     */
+    struct Hedge {
+        std::string path;
+        std::string body;
+        std::string contentType;
+        std::string accept;
+        Clock::time_point deadline;
+        Clock::time_point submitted = Clock::now();
+        Callback callback;
+        Backend* primary = nullptr;
+        HttpRequestPool::CancelFlag primaryCancel;
+        HttpRequestPool::CancelFlag hedgeCancel;
+        std::mutex mutex;
+        int inFlight = 1;
+        bool delivered = false;
+    };
+
+    bool
+    isActive(const Backend& backend, Clock::time_point now) const {
+        return backend.healthy && now >= backend.ejectedUntil && !backend.breaker->isOpen();
+    }
+
+    /**
+     * @brief El servidor activo con menos peticiones pendientes; si no hay ninguno activo,
+     * el de menos pendientes entre todos (su cortacircuitos decidirá si se envía).
+     * Los empates se reparten por turnos.
+     * @param avoid Servidor que solo se elige si no hay otro activo (el de la petición original).
+     */
+    Backend&
+    choose(const Backend* avoid = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (backends_.size() > 1 && !health_thread_.joinable()) {
+            health_thread_ = std::thread([this]() { healthLoop(); });
+        }
+        if (avoid == nullptr) {
+            ++requests_;
+        }
+        const Clock::time_point now = Clock::now();
+        const size_t start = next_++;
+        Backend* best = nullptr;
+        size_t best_outstanding = 0;
+        bool best_active = false;
+        for (size_t i = 0; i < backends_.size(); ++i) {
+            Backend& backend = *backends_[(start + i) % backends_.size()];
+            const bool active = isActive(backend, now) && &backend != avoid;
+            const size_t outstanding = backend.pool->outstanding();
+            if (best == nullptr || (active && !best_active) ||
+                (active == best_active && outstanding < best_outstanding)) {
+                best = &backend;
+                best_outstanding = outstanding;
+                best_active = active;
+            }
+        }
+        return *best;
+    }
+
+    /**
+     * @brief Guarda la latencia de la ruta (desde que se encoló) y la media del servidor,
+     * y expulsa a este si es mucho más lento que el resto.
+     */
+    void
+    recordReply(Backend& backend, const std::string& path, const HttpReply& reply, Clock::time_point submitted) {
+        if (!reply.ok()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Clock::time_point now = Clock::now();
+        auto& window = latencies_[path];
+        window.push_back(std::chrono::duration<double>(now - submitted).count());
+        if (window.size() > LATENCY_WINDOW) {
+            window.pop_front();
+        }
+        if (backends_.size() < 2) {
+            return;
+        }
+        if (now < backend.ejectedUntil) {
+            // Respuestas que ya estaban en su cola; no cuentan para la próxima evaluación.
+            return;
+        }
+        backend.averageSeconds = backend.samples == 0
+                                     ? reply.seconds
+                                     : (1.0 - LATENCY_SMOOTHING) * backend.averageSeconds +
+                                       LATENCY_SMOOTHING * reply.seconds;
+        ++backend.samples;
+        if (backend.samples < MIN_SAMPLES) {
+            return;
+        }
+
+        std::vector<double> others;
+        for (const auto& other : backends_) {
+            if (other.get() != &backend && isActive(*other, now) && other->samples >= MIN_SAMPLES) {
+                others.push_back(other->averageSeconds);
+            }
+        }
+        if (others.empty()) {
+            return;
+        }
+        std::nth_element(others.begin(), others.begin() + others.size() / 2, others.end());
+        const double median = others[others.size() / 2];
+        if (backend.averageSeconds > EJECTION_FACTOR * median && backend.averageSeconds > EJECTION_MIN_SECONDS) {
+            backend.ejectedUntil = now + EJECTION_TIME;
+            backend.samples = 0;
+            std::cerr << "Aviso: servidor " << backend.baseUrl << " expulsado durante " << EJECTION_TIME.count()
+                << " s por lentitud (" << backend.averageSeconds << " s de media frente a " << median << " s)."
+                << std::endl;
+        }
+    }
+
+    /**
+     * @brief Espera antes de enviar la copia de cobertura: el percentil HEDGE_PERCENTILE de la latencia
+     * reciente de la ruta, o nada si aún no hay suficientes muestras.
+     */
+    std::optional<Clock::duration>
+    hedgeDelay(const std::string& path) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = latencies_.find(path);
+        if (it == latencies_.end() || it->second.size() < HEDGE_MIN_SAMPLES) {
+            return std::nullopt;
+        }
+        std::vector<double> samples(it->second.begin(), it->second.end());
+        auto percentile = samples.begin() + static_cast<size_t>(HEDGE_PERCENTILE * (samples.size() - 1));
+        std::nth_element(samples.begin(), percentile, samples.end());
+        auto delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(*percentile));
+        return std::max<Clock::duration>(delay, HEDGE_MIN_DELAY);
+    }
+
+    /**
+     * @brief Entrega la primera respuesta correcta de una petición con cobertura y cancela la otra copia.
+     * Una respuesta fallida solo se entrega si ya no queda ninguna copia en curso.
+     */
+    void
+    finishHedge(Hedge& hedge, HttpReply reply, bool fromHedge) {
+        {
+            std::lock_guard<std::mutex> lock(hedge.mutex);
+            --hedge.inFlight;
+            if (hedge.delivered || (!reply.ok() && hedge.inFlight > 0)) {
+                return;
+            }
+            hedge.delivered = true;
+            (fromHedge ? hedge.primaryCancel : hedge.hedgeCancel)->store(true);
+        }
+        hedge.callback(std::move(reply));
+    }
+
+    /**
+     * @brief Hilo de cobertura: al vencer la espera de cada petición aún sin respuesta, envía su copia.
+     */
+    void
+    hedgeLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (hedge_timers_.empty()) {
+                hedge_ready_.wait(lock);
+                continue;
+            }
+            auto next = hedge_timers_.begin();
+            if (Clock::now() < next->first) {
+                hedge_ready_.wait_until(lock, next->first);
+                continue;
+            }
+            std::shared_ptr<Hedge> hedge = next->second.lock();
+            hedge_timers_.erase(next);
+            if (!hedge || hedges_ >= HEDGE_BUDGET * requests_) {
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> hedge_lock(hedge->mutex);
+                if (hedge->delivered || Clock::now() >= hedge->deadline) {
+                    continue;
+                }
+                ++hedge->inFlight;
+            }
+            ++hedges_;
+            lock.unlock();
+            Backend& backend = choose(hedge->primary);
+            // La latencia de la copia se mide desde su propio envío: contar también la espera de
+            // cobertura haría subir el percentil con cada copia.
+            const Clock::time_point submitted = Clock::now();
+            backend.pool->submit(hedge->path, hedge->body, hedge->contentType,
+                                 [this, &backend, hedge, submitted](HttpReply reply) {
+                                     recordReply(backend, hedge->path, reply, submitted);
+                                     finishHedge(*hedge, std::move(reply), true);
+                                 }, hedge->deadline, hedge->accept, hedge->hedgeCancel);
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief Comprueba cada HEALTH_INTERVAL que los servidores responden a GET 'health_path_'.
+     */
+    void
+    healthLoop() {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (stop_signal_.wait_for(lock, HEALTH_INTERVAL, [this]() { return stopping_; })) {
+                    return;
+                }
+            }
+            for (const auto& backend : backends_) {
+                httplib::Client client(backend->baseUrl);
+                client.set_connection_timeout(std::chrono::seconds(1));
+                client.set_read_timeout(std::chrono::seconds(1));
+                auto res = client.Get(health_path_);
+                if (!res && backend->pool->outstanding() > 0) {
+                    // Un servidor ocupado con nuestras peticiones puede tardar en atender la comprobación;
+                    // sin respuesta no se sabe nada, y sus propias peticiones ya informan al cortacircuitos.
+                    continue;
+                }
+                const bool healthy = res && res->status < 500;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (healthy != backend->healthy) {
+                    std::cerr << "Aviso: servidor " << backend->baseUrl
+                        << (healthy ? " de nuevo sano." : " no supera la comprobación de salud.") << std::endl;
+                }
+                backend->healthy = healthy;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Backend>> backends_;
+    std::string health_path_;
+    mutable std::mutex mutex_;
+    std::condition_variable stop_signal_;
+    std::condition_variable hedge_ready_;
+    std::thread health_thread_;
+    std::thread hedge_thread_;
+    std::unordered_map<std::string, std::deque<double>> latencies_;
+    std::multimap<Clock::time_point, std::weak_ptr<Hedge>> hedge_timers_;
+    size_t next_ = 0;
+    uint64_t requests_ = 0;
+    uint64_t hedges_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @brief Modos de operación disponibles para cifradores de bloque de 64 bits.
+ */
+enum class BlockMode {
+    ECB,
+    CBC,
+    CTR
+};
+
+/**
+ * @brief Cifrado/descifrado por flujo para cualquier cifrador de bloque de 64 bits
+ * que exponga encodeBlock(uint64_t) y decodeBlock(uint64_t) (DES, TripleDES).
+ * Los datos se entregan por partes con update() y se cierran con finish();
+ * ECB y CBC usan relleno PKCS#7, CTR no necesita relleno.
+ */
+template <typename Cipher>
+class BlockCipherStream {
+public:
+    BlockCipherStream(const Cipher& cipher, BlockMode mode, bool encrypting, uint64_t iv = 0) :
+        cipher_(cipher), mode_(mode), encrypting_(encrypting), chain_(iv) {
+    }
+
+    ~BlockCipherStream() = default;
+
+    /**
+     * @brief Procesa un fragmento de datos y devuelve los bloques que ya se pueden emitir.
+     * @param chunk Los bytes de entrada.
+     * @return Los bytes de salida disponibles hasta el momento.
+     */
+    std::string
+    update(const std::string& chunk) {
+        std::string output;
+        pending_ += chunk;
+
+        // Al descifrar con relleno se retiene el último bloque completo hasta finish().
+        size_t keep = (!encrypting_ && mode_ != BlockMode::CTR) ? BLOCK_SIZE : 0;
+        size_t usable = pending_.size() > keep ? pending_.size() - keep : 0;
+        size_t full_blocks = usable / BLOCK_SIZE;
+
+        output.reserve(full_blocks * BLOCK_SIZE);
+        for (size_t i = 0; i < full_blocks; ++i) {
+            uint64_t block = loadBlock(pending_, i * BLOCK_SIZE);
+            appendBlock(output, processBlock(block));
+        }
+        pending_.erase(0, full_blocks * BLOCK_SIZE);
+        return output;
+    }
+
+    /**
+     * @brief Procesa los datos pendientes y aplica o retira el relleno.
+     * @return Los últimos bytes de salida.
+     * @throws std::runtime_error Si al descifrar la longitud o el relleno no son válidos.
+     */
+    std::string
+    finish() {
+        std::string output;
+
+        if (mode_ == BlockMode::CTR) {
+            if (!pending_.empty()) {
+                std::string padded = pending_ + std::string(BLOCK_SIZE - pending_.size(), '\0');
+                appendBlock(output, processBlock(loadBlock(padded, 0)));
+                output.resize(pending_.size());
+            }
+            pending_.clear();
+            return output;
+        }
+
+        if (encrypting_) {
+            size_t padding = BLOCK_SIZE - pending_.size() % BLOCK_SIZE;
+            pending_.append(padding, static_cast<char>(padding));
+            output = update("");
+            return output;
+        }
+
+        if (pending_.size() != BLOCK_SIZE) {
+            throw std::runtime_error("Longitud de texto cifrado inválida para el modo de bloque.");
+        }
+        appendBlock(output, processBlock(loadBlock(pending_, 0)));
+        pending_.clear();
+
+        unsigned char padding = static_cast<unsigned char>(output.back());
+        if (padding == 0 || padding > BLOCK_SIZE) {
+            throw std::runtime_error("Relleno PKCS#7 inválido.");
+        }
+        for (size_t i = output.size() - padding; i < output.size(); ++i) {
+            if (static_cast<unsigned char>(output[i]) != padding) {
+                throw std::runtime_error("Relleno PKCS#7 inválido.");
+            }
+        }
+        output.resize(output.size() - padding);
+        return output;
+    }
+
+    static constexpr size_t BLOCK_SIZE = 8;
+
+private:
+    uint64_t
+    processBlock(uint64_t block) {
+        switch (mode_) {
+        case BlockMode::ECB:
+            return encrypting_ ? cipher_.encodeBlock(block) : cipher_.decodeBlock(block);
+        case BlockMode::CBC:
+            if (encrypting_) {
+                chain_ = cipher_.encodeBlock(block ^ chain_);
+                return chain_;
+            } else {
+                uint64_t plain = cipher_.decodeBlock(block) ^ chain_;
+                chain_ = block;
+                return plain;
+            }
+        case BlockMode::CTR:
+        default:
+            return block ^ cipher_.encodeBlock(chain_++);
+        }
+    }
+
+    static uint64_t
+    loadBlock(const std::string& data, size_t offset) {
+        uint64_t block = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            block = (block << 8) | static_cast<unsigned char>(data[offset + i]);
+        }
+        return block;
+    }
+
+    static void
+    appendBlock(std::string& output, uint64_t block) {
+        for (int i = 7; i >= 0; --i) {
+            output.push_back(static_cast<char>((block >> (i * 8)) & 0xFF));
+        }
+    }
+
+    const Cipher& cipher_;
+    BlockMode mode_;
+    bool encrypting_;
+    uint64_t chain_;
+    std::string pending_;
+};
+
+/**
+ * @brief Cifra un mensaje completo con el modo indicado.
+ */
+template <typename Cipher>
+std::string
+encryptWithMode(const Cipher& cipher, BlockMode mode, const std::string& plaintext, uint64_t iv = 0) {
+    BlockCipherStream<Cipher> stream(cipher, mode, true, iv);
+    std::string output = stream.update(plaintext);
+    output += stream.finish();
+    return output;
+}
+
+/**
+ * @brief Descifra un mensaje completo con el modo indicado.
+ */
+template <typename Cipher>
+std::string
+decryptWithMode(const Cipher& cipher, BlockMode mode, const std::string& ciphertext, uint64_t iv = 0) {
+    BlockCipherStream<Cipher> stream(cipher, mode, false, iv);
+    std::string output = stream.update(ciphertext);
+    output += stream.finish();
+    return output;
+}
@@ -0,0 +1,228 @@
+#pragma once
+#include "CesarKernel.h"
+#include "LetterFrequency.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Estadísticas de una ejecución por lotes.
+ */
+struct CesarBatchStats {
+    uint64_t lines = 0;
+    uint64_t bytes = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Criptoanálisis César por lotes de archivos con una línea cifrada por mensaje.
+ * La entrada se lee en bloques grandes cortados en fin de línea; cada bloque se procesa en un hilo
+ * del grupo (histograma + rotación contra el perfil del español + núcleo César) y produce líneas
+ * "clave<TAB>texto plano" en su propio búfer. Un hilo escritor vuelca cada búfer completo con un
+ * solo fwrite, en el orden original.
+ */
+class CesarBatchCracker {
+public:
+    CesarBatchCracker(unsigned int threads = 0, size_t chunkBytes = 4 << 20) :
+        threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+        chunk_bytes_(std::max<size_t>(chunkBytes, 4096)) {
+    }
+
+    ~CesarBatchCracker() = default;
+
+    /**
+     * @brief Procesa un archivo de entrada y escribe el resultado en otro.
+     * @param inputPath Ruta de entrada, o "-" para la entrada estándar.
+     * @param outputPath Ruta de salida, o "-" para la salida estándar.
+     * @throws std::runtime_error Si no se puede abrir alguno de los archivos.
+     */
+    CesarBatchStats
+    run(const std::string& inputPath, const std::string& outputPath) const {
+        std::FILE* input = inputPath == "-" ? stdin : std::fopen(inputPath.c_str(), "rb");
+        if (input == nullptr) {
+            throw std::runtime_error("No se pudo abrir la entrada: " + inputPath);
+        }
+        std::FILE* output = outputPath == "-" ? stdout : std::fopen(outputPath.c_str(), "wb");
+        if (output == nullptr) {
+            if (input != stdin) {
+                std::fclose(input);
+            }
+            throw std::runtime_error("No se pudo crear la salida: " + outputPath);
+        }
+        CesarBatchStats stats = run(input, output);
+        if (input != stdin) {
+            std::fclose(input);
+        }
+        if (output != stdout) {
+            std::fclose(output);
+        }
+        return stats;
+    }
+
+    /**
+     * @brief Procesa todas las líneas de 'input' y escribe "clave<TAB>texto plano" por línea en 'output'.
+     */
+    CesarBatchStats
+    run(std::FILE* input, std::FILE* output) const {
+        auto start_time = std::chrono::steady_clock::now();
+        CesarBatchStats stats;
+
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable space_ready;
+        std::condition_variable result_ready;
+        std::deque<std::pair<uint64_t, std::string>> jobs;
+        std::map<uint64_t, std::string> results;
+        bool reading_done = false;
+        uint64_t next_to_write = 0;
+        uint64_t chunks_read = 0;
+        const size_t max_pending = threads_ * 2;
+
+        auto worker = [&]() {
+            std::string out;
+            for (;;) {
+                std::pair<uint64_t, std::string> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    work_ready.wait(lock, [&]() { return !jobs.empty() || reading_done; });
+                    if (jobs.empty()) {
+                        return;
+                    }
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+                out.clear();
+                crackChunk(job.second.data(), job.second.size(), out);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results.emplace(job.first, std::move(out));
+                }
+                out = std::string();
+                result_ready.notify_all();
+            }
+        };
+
+        auto writer = [&]() {
+            for (;;) {
+                std::string block;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    result_ready.wait(lock, [&]() {
+                        return results.count(next_to_write) != 0 || (reading_done && next_to_write == chunks_read);
+                    });
+                    auto it = results.find(next_to_write);
+                    if (it == results.end()) {
+                        break;
+                    }
+                    block = std::move(it->second);
+                    results.erase(it);
+                    ++next_to_write;
+                }
+                space_ready.notify_one();
+                std::fwrite(block.data(), 1, block.size(), output);
+            }
+            std::fflush(output);
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads_; ++t) {
+            workers.emplace_back(worker);
+        }
+        std::thread writer_thread(writer);
+
+        // Lectura en bloques; lo que queda tras el último '\n' pasa al bloque siguiente.
+        std::string carry;
+        std::vector<char> buffer(chunk_bytes_);
+        for (;;) {
+            size_t read = std::fread(buffer.data(), 1, buffer.size(), input);
+            bool eof = read < buffer.size();
+            stats.bytes += read;
+
+            std::string chunk;
+            chunk.reserve(carry.size() + read);
+            chunk.append(carry);
+            chunk.append(buffer.data(), read);
+            carry.clear();
+            if (!eof) {
+                size_t last_newline = chunk.rfind('\n');
+                if (last_newline == std::string::npos) {
+                    carry.swap(chunk);
+                    continue;
+                }
+                carry.assign(chunk, last_newline + 1, std::string::npos);
+                chunk.resize(last_newline + 1);
+            }
+            stats.lines += countLines(chunk);
+
+            if (!chunk.empty()) {
+                std::unique_lock<std::mutex> lock(mutex);
+                space_ready.wait(lock, [&]() { return jobs.size() + results.size() < max_pending; });
+                jobs.emplace_back(chunks_read++, std::move(chunk));
+                lock.unlock();
+                work_ready.notify_one();
+            }
+            if (eof) {
+                break;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            reading_done = true;
+        }
+        work_ready.notify_all();
+        result_ready.notify_all();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        result_ready.notify_all();
+        writer_thread.join();
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return stats;
+    }
+
+    /**
+     * @brief Descifra cada línea de un bloque con su clave más probable y añade "clave<TAB>texto\n" a 'out'.
+     * Los '\r' finales se descartan.
+     */
+    static void
+    crackChunk(const char* data, size_t length, std::string& out) {
+        out.reserve(out.size() + length + length / 8 + 16);
+        size_t line_start = 0;
+        while (line_start < length) {
+            const char* newline = static_cast<const char*>(std::memchr(data + line_start, '\n', length - line_start));
+            size_t line_end = newline != nullptr ? static_cast<size_t>(newline - data) : length;
+            size_t content_end = line_end;
+            if (content_end > line_start && data[content_end - 1] == '\r') {
+                --content_end;
+            }
+            const char* line = data + line_start;
+            size_t line_length = content_end - line_start;
+
+            int key = LetterFrequency::bestShift(LetterFrequency::histogram(line, line_length));
+            int shift = CesarKernel::decodeShift(key);
+            if (key >= 10) {
+                out.push_back(static_cast<char>('0' + key / 10));
+            }
+            out.push_back(static_cast<char>('0' + key % 10));
+            out.push_back('\t');
+            size_t offset = out.size();
+            out.resize(offset + line_length);
+            CesarKernel::transform(line, line_length, &out[offset], shift, shift % 10);
+            out.push_back('\n');
+
+            line_start = line_end + 1;
+        }
+    }
+
+private:
+    static uint64_t
+    countLines(const std::string& chunk) {
+        uint64_t lines = static_cast<uint64_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+        if (!chunk.empty() && chunk.back() != '\n') {
+            ++lines;
+        }
+        return lines;
+    }
+
+    unsigned int threads_;
+    size_t chunk_bytes_;
+};
@@ -0,0 +1,247 @@
+#pragma once
+#include "Prerequisites.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CESAR_KERNEL_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define CESAR_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Generación en tiempo de compilación de las tablas de traducción del cifrado César.
+ */
+class CesarTables {
+public:
+    using Table = std::array<unsigned char, 256>;
+    using Tables26 = std::array<Table, 26>;
+    using Tables10 = std::array<Table, 10>;
+
+    static constexpr Tables26
+    buildLetterTables() {
+        Tables26 tables{};
+        for (int shift = 0; shift < 26; ++shift) {
+            for (int c = 0; c < 256; ++c) {
+                int value = c;
+                if (c >= 'A' && c <= 'Z') {
+                    value = 'A' + (c - 'A' + shift) % 26;
+                } else if (c >= 'a' && c <= 'z') {
+                    value = 'a' + (c - 'a' + shift) % 26;
+                }
+                tables[shift][c] = static_cast<unsigned char>(value);
+            }
+        }
+        return tables;
+    }
+
+    static constexpr Tables10
+    buildDigitTables() {
+        Tables10 tables{};
+        for (int shift = 0; shift < 10; ++shift) {
+            for (int c = 0; c < 256; ++c) {
+                int value = (c >= '0' && c <= '9') ? '0' + (c - '0' + shift) % 10 : c;
+                tables[shift][c] = static_cast<unsigned char>(value);
+            }
+        }
+        return tables;
+    }
+};
+
+/**
+ * @brief Núcleo del cifrado César sobre bloques de memoria.
+ * Las tablas de traducción de 256 bytes para cada desplazamiento se generan en compilación y se
+ * usan en la parte escalar; los bloques de 16/32 bytes se transforman con SSE2/AVX2 comparando
+ * rangos (A-Z, a-z, 0-9) y sumando el desplazamiento con su vuelta, sin saltos por carácter.
+ */
+class CesarKernel {
+public:
+    using Table = CesarTables::Table;
+
+    /**
+     * @brief Tabla que desplaza las letras A-Z/a-z 'shift' posiciones y deja el resto igual.
+     */
+    static const Table&
+    letterTable(int shift) {
+        return LETTER_TABLES[shift];
+    }
+
+    /**
+     * @brief Tabla que desplaza los dígitos 0-9 'shift' posiciones y deja el resto igual.
+     */
+    static const Table&
+    digitTable(int shift) {
+        return DIGIT_TABLES[shift];
+    }
+
+    /**
+     * @brief Aplica el cifrado César a un bloque escribiendo en el búfer del llamador.
+     * @param src Texto de entrada.
+     * @param length Longitud en bytes.
+     * @param dst Búfer de salida de al menos 'length' bytes (puede ser igual a 'src').
+     * @param letterShift Desplazamiento de las letras (0-25).
+     * @param digitShift Desplazamiento de los dígitos (0-9).
+     */
+    static void
+    transform(const char* src, size_t length, char* dst, int letterShift, int digitShift) {
+        size_t i = 0;
+#if CESAR_KERNEL_AVX2
+        const Deltas256 deltas256(letterShift, digitShift);
+        for (; i + 32 <= length; i += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), deltas256.apply(block));
+        }
+#endif
+#if CESAR_KERNEL_SSE2
+        const Deltas128 deltas128(letterShift, digitShift);
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), deltas128.apply(block));
+        }
+#endif
+        transformScalar(src + i, length - i, dst + i, letterShift, digitShift);
+    }
+
+    /**
+     * @brief Produce los 26 descifrados posibles leyendo la entrada una sola vez.
+     * La fila k de 'dst' es el descifrado con la clave k (mismo resultado que CesarEncryption::decode).
+     * @param src Texto cifrado.
+     * @param length Longitud en bytes.
+     * @param dst Búfer de salida de 26 * 'length' bytes.
+     */
+    static void
+    decodeAll(const char* src, size_t length, char* dst) {
+        size_t i = 0;
+#if CESAR_KERNEL_SSE2
+        std::vector<Deltas128> deltas;
+        deltas.reserve(26);
+        for (int key = 0; key < 26; ++key) {
+            int shift = decodeShift(key);
+            deltas.emplace_back(shift, shift % 10);
+        }
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            for (int key = 0; key < 26; ++key) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + key * length + i), deltas[key].apply(block));
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(src[i]);
+            for (int key = 0; key < 26; ++key) {
+                int shift = decodeShift(key);
+                dst[key * length + i] = static_cast<char>(DIGIT_TABLES[shift % 10][LETTER_TABLES[shift][c]]);
+            }
+        }
+    }
+
+    /**
+     * @brief Desplazamiento de cifrado equivalente a descifrar con la clave dada.
+     */
+    static constexpr int
+    decodeShift(int key) {
+        return (26 - (key % 26)) % 26;
+    }
+
+private:
+    static constexpr CesarTables::Tables26 LETTER_TABLES = CesarTables::buildLetterTables();
+    static constexpr CesarTables::Tables10 DIGIT_TABLES = CesarTables::buildDigitTables();
+
+    static void
+    transformScalar(const char* src, size_t length, char* dst, int letterShift, int digitShift) {
+        const Table& letters = LETTER_TABLES[letterShift];
+        const Table& digits = DIGIT_TABLES[digitShift];
+        for (size_t i = 0; i < length; ++i) {
+            // Las letras nunca se convierten en dígitos ni al revés, así que las tablas se componen.
+            dst[i] = static_cast<char>(digits[letters[static_cast<unsigned char>(src[i])]]);
+        }
+    }
+
+#if CESAR_KERNEL_SSE2
+    /**
+     * @brief Constantes de un desplazamiento para el núcleo de 16 bytes.
+     * Para cada byte: t = (c | 0x20) - 'a' está en [0, 25] si es letra; se suma 'shift' o 'shift - 26'
+     * según t >= 26 - shift. Los dígitos se tratan igual con d = c - '0' y módulo 10.
+     */
+    struct Deltas128 {
+        Deltas128(int letterShift, int digitShift) :
+            letterShift(_mm_set1_epi8(static_cast<char>(letterShift))),
+            letterWrap(_mm_set1_epi8(static_cast<char>(letterShift - 26))),
+            letterLimit(_mm_set1_epi8(static_cast<char>(26 - letterShift))),
+            digitShift(_mm_set1_epi8(static_cast<char>(digitShift))),
+            digitWrap(_mm_set1_epi8(static_cast<char>(digitShift - 10))),
+            digitLimit(_mm_set1_epi8(static_cast<char>(10 - digitShift))) {
+        }
+
+        __m128i
+        apply(__m128i block) const {
+            const __m128i case_bit = _mm_set1_epi8(0x20);
+            __m128i t = _mm_sub_epi8(_mm_or_si128(block, case_bit), _mm_set1_epi8('a'));
+            __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(25)), t);
+            __m128i letter_wraps = _mm_cmpeq_epi8(_mm_max_epu8(t, letterLimit), t);
+            __m128i letter_delta = select(letter_wraps, letterWrap, letterShift);
+
+            __m128i d = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+            __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+            __m128i digit_wraps = _mm_cmpeq_epi8(_mm_max_epu8(d, digitLimit), d);
+            __m128i digit_delta = select(digit_wraps, digitWrap, digitShift);
+
+            __m128i delta = _mm_or_si128(_mm_and_si128(is_letter, letter_delta), _mm_and_si128(is_digit, digit_delta));
+            return _mm_add_epi8(block, delta);
+        }
+
+        static __m128i
+        select(__m128i mask, __m128i ifSet, __m128i ifClear) {
+            return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, ifClear));
+        }
+
+        __m128i letterShift;
+        __m128i letterWrap;
+        __m128i letterLimit;
+        __m128i digitShift;
+        __m128i digitWrap;
+        __m128i digitLimit;
+    };
+#endif
+
+#if CESAR_KERNEL_AVX2
+    /**
+     * @brief Mismo núcleo que Deltas128 sobre bloques de 32 bytes.
+     */
+    struct Deltas256 {
+        Deltas256(int letterShift, int digitShift) :
+            letterShift(_mm256_set1_epi8(static_cast<char>(letterShift))),
+            letterWrap(_mm256_set1_epi8(static_cast<char>(letterShift - 26))),
+            letterLimit(_mm256_set1_epi8(static_cast<char>(26 - letterShift))),
+            digitShift(_mm256_set1_epi8(static_cast<char>(digitShift))),
+            digitWrap(_mm256_set1_epi8(static_cast<char>(digitShift - 10))),
+            digitLimit(_mm256_set1_epi8(static_cast<char>(10 - digitShift))) {
+        }
+
+        __m256i
+        apply(__m256i block) const {
+            __m256i t = _mm256_sub_epi8(_mm256_or_si256(block, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(25)), t);
+            __m256i letter_wraps = _mm256_cmpeq_epi8(_mm256_max_epu8(t, letterLimit), t);
+            __m256i letter_delta = _mm256_blendv_epi8(letterShift, letterWrap, letter_wraps);
+
+            __m256i d = _mm256_sub_epi8(block, _mm256_set1_epi8('0'));
+            __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+            __m256i digit_wraps = _mm256_cmpeq_epi8(_mm256_max_epu8(d, digitLimit), d);
+            __m256i digit_delta = _mm256_blendv_epi8(digitShift, digitWrap, digit_wraps);
+
+            __m256i delta = _mm256_or_si256(_mm256_and_si256(is_letter, letter_delta),
+                                            _mm256_and_si256(is_digit, digit_delta));
+            return _mm256_add_epi8(block, delta);
+        }
+
+        __m256i letterShift;
+        __m256i letterWrap;
+        __m256i letterLimit;
+        __m256i digitShift;
+        __m256i digitWrap;
+        __m256i digitLimit;
+    };
+#endif
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @brief Cortacircuitos para un servidor remoto.
+ * Tras 'failureThreshold' fallos seguidos el circuito se abre y las peticiones se rechazan sin tocar la red.
+ * Pasado el tiempo de espera se deja pasar una única petición de sondeo: si funciona el circuito se cierra;
+ * si falla vuelve a abrirse con el doble de espera (hasta 'maxBackoff'). Es seguro entre hilos.
+ */
+class CircuitBreaker {
+public:
+    enum class State {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param name Nombre usado en los avisos (p. ej. la URL del servidor).
+     * @param failureThreshold Fallos consecutivos que abren el circuito.
+     * @param initialBackoff Espera antes del primer sondeo.
+     * @param maxBackoff Espera máxima entre sondeos.
+     */
+    CircuitBreaker(const std::string& name = "",
+                   size_t failureThreshold = 3,
+                   std::chrono::milliseconds initialBackoff = std::chrono::seconds(1),
+                   std::chrono::milliseconds maxBackoff = std::chrono::seconds(60)) :
+        name_(name), failure_threshold_(std::max<size_t>(1, failureThreshold)),
+        initial_backoff_(initialBackoff), max_backoff_(std::max(maxBackoff, initialBackoff)),
+        backoff_(initialBackoff) {
+    }
+
+    /**
+     * @brief Cortacircuitos compartido por todos los clientes del mismo servidor.
+     */
+    static std::shared_ptr<CircuitBreaker>
+    forServer(const std::string& base_url) {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::shared_ptr<CircuitBreaker>> breakers;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& breaker = breakers[base_url];
+        if (!breaker) {
+            breaker = std::make_shared<CircuitBreaker>(base_url);
+        }
+        return breaker;
+    }
+
+    /**
+     * @brief Indica si se puede enviar una petición ahora. Con el circuito abierto y la espera cumplida,
+     * la primera llamada obtiene el sondeo; quien recibe true debe informar después del resultado.
+     */
+    bool
+    allowRequest() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (state_) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (Clock::now() >= next_probe_) {
+                state_ = State::HalfOpen;
+                return true;
+            }
+            return false;
+        case State::HalfOpen:
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Informa de una petición correcta: cierra el circuito.
+     */
+    void
+    recordSuccess() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::Closed) {
+            std::cerr << "Aviso: servidor " << name_ << " disponible de nuevo." << std::endl;
+        }
+        state_ = State::Closed;
+        consecutive_failures_ = 0;
+        backoff_ = initial_backoff_;
+    }
+
+    /**
+     * @brief Informa de un fallo (sin conexión, tiempo agotado o error del servidor).
+     */
+    void
+    recordFailure() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::HalfOpen) {
+            backoff_ = std::min(backoff_ * 2, max_backoff_);
+            open();
+            return;
+        }
+        if (state_ == State::Closed && ++consecutive_failures_ >= failure_threshold_) {
+            open();
+        }
+    }
+
+    /**
+     * @brief Informa de una petición cortada por el plazo del llamador, que no dice nada del servidor:
+     * no cuenta como fallo, pero si era el sondeo este se repetirá tras la misma espera.
+     */
+    void
+    recordAbandoned() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::HalfOpen) {
+            state_ = State::Open;
+            next_probe_ = Clock::now() + backoff_;
+        }
+    }
+
+    /**
+     * @brief true si el circuito está abierto y todavía no toca sondear; no consume el sondeo.
+     */
+    bool
+    isOpen() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_ == State::HalfOpen || (state_ == State::Open && Clock::now() < next_probe_);
+    }
+
+    State
+    state() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_;
+    }
+
+private:
+    void
+    open() {
+        state_ = State::Open;
+        next_probe_ = Clock::now() + backoff_;
+        std::cerr << "Aviso: servidor " << name_ << " no responde; se omite durante "
+            << backoff_.count() << " ms." << std::endl;
+    }
+
+    std::string name_;
+    size_t failure_threshold_;
+    std::chrono::milliseconds initial_backoff_;
+    std::chrono::milliseconds max_backoff_;
+    std::chrono::milliseconds backoff_;
+    mutable std::mutex mutex_;
+    State state_ = State::Closed;
+    size_t consecutive_failures_ = 0;
+    Clock::time_point next_probe_{};
+};
@@ -13,6 +13,17 @@ public:
 
     ~DES() = default;
 
+    /**
+     * @brief Bits de la clave que realmente intervienen en las subclaves (bits 1 a 48).
+     * El resto de bits de la clave no afecta al cifrado.
+     */
+    static constexpr uint64_t EFFECTIVE_KEY_MASK = 0x0001FFFFFFFFFFFEULL;
+
+    /**
+     * @brief Subclaves de las 16 rondas en formato entero para la ruta rápida.
+     */
+    using FastSchedule = std::array<uint64_t, 16>;
+
     /**
      * @brief Genera las subclaves necesarias para el cifrado/descifrado DES.
      */
@@ -21,6 +32,20 @@ public:
             std::bitset<48> subkey((key.to_ullong() >> 1) & 0xFFFFFFFFFFFF);
             subkeys.push_back(subkey);
         }
+        fastSubkeys = fastSchedule(key.to_ullong());
+    }
+
+    /**
+     * @brief Calcula las subclaves de la ruta rápida a partir de una clave de 64 bits.
+     * Sigue la misma derivación que generateSubkeys(), sin reservar memoria.
+     * @param key La clave de 64 bits.
+     * @return Las 16 subclaves de 48 bits.
+     */
+    static FastSchedule
+    fastSchedule(uint64_t key) {
+        FastSchedule schedule;
+        schedule.fill((key >> 1) & 0xFFFFFFFFFFFFULL);
+        return schedule;
     }
 
     /**
@@ -159,6 +184,108 @@ public:
         return fPermutation(std::bitset<64>(combined));
     }
 
+    /**
+     * @brief Codifica un bloque de 64 bits usando las tablas precalculadas.
+     * Produce la misma salida que encode(), pero sin bitsets ni reservas de memoria.
+     * @param plaintext El bloque de 64 bits de texto plano.
+     * @return El bloque de 64 bits de texto cifrado.
+     */
+    uint64_t
+    encodeBlock(uint64_t plaintext) const {
+        return encodeWithSchedule(plaintext, fastSubkeys);
+    }
+
+    /**
+     * @brief Decodifica un bloque de 64 bits usando las tablas precalculadas.
+     * @param ciphertext El bloque de 64 bits de texto cifrado.
+     * @return El bloque de 64 bits de texto plano.
+     */
+    uint64_t
+    decodeBlock(uint64_t ciphertext) const {
+        return decodeWithSchedule(ciphertext, fastSubkeys);
+    }
+
+    /**
+     * @brief Codifica un bloque con un conjunto de subclaves dado (sin construir un objeto DES).
+     * Pensado para búsquedas de claves, donde se prueban millones de claves distintas.
+     * @param plaintext El bloque de 64 bits de texto plano.
+     * @param schedule Las subclaves obtenidas con fastSchedule().
+     * @return El bloque de 64 bits de texto cifrado.
+     */
+    static uint64_t
+    encodeWithSchedule(uint64_t plaintext, const FastSchedule& schedule) {
+        return fPermutationFast(feistelRounds(iPermutationFast(plaintext), schedule, false));
+    }
+
+    /**
+     * @brief Decodifica un bloque con un conjunto de subclaves dado.
+     * @param ciphertext El bloque de 64 bits de texto cifrado.
+     * @param schedule Las subclaves obtenidas con fastSchedule().
+     * @return El bloque de 64 bits de texto plano.
+     */
+    static uint64_t
+    decodeWithSchedule(uint64_t ciphertext, const FastSchedule& schedule) {
+        return fPermutationFast(feistelRounds(iPermutationFast(ciphertext), schedule, true));
+    }
+
+    /**
+     * @brief Aplica la permutación inicial mediante tablas (equivalente a iPermutation()).
+     */
+    static uint64_t
+    iPermutationFast(uint64_t input) {
+        return permuteBytes(fastTables().ip, input);
+    }
+
+    /**
+     * @brief Aplica la permutación final mediante tablas (equivalente a fPermutation()).
+     */
+    static uint64_t
+    fPermutationFast(uint64_t input) {
+        return permuteBytes(fastTables().fp, input);
+    }
+
+    /**
+     * @brief Ejecuta las 16 rondas Feistel (incluido el intercambio final) sin permutaciones IP/FP.
+     * Permite encadenar varias pasadas DES sin aplicar pares FP/IP intermedios.
+     * @param block El bloque de 64 bits ya permutado.
+     * @param schedule Las subclaves de las 16 rondas.
+     * @param reverse Si es true, recorre las subclaves en orden inverso (descifrado).
+     * @return El bloque de 64 bits antes de la permutación final.
+     */
+    static uint64_t
+    feistelRounds(uint64_t block, const FastSchedule& schedule, bool reverse) {
+        const FastTables& tables = fastTables();
+        uint32_t left = static_cast<uint32_t>(block >> 32);
+        uint32_t right = static_cast<uint32_t>(block);
+
+        for (int round = 0; round < 16; ++round) {
+            uint32_t newRight = left ^ feistelFast(tables, right, schedule[reverse ? 15 - round : round]);
+            left = right;
+            right = newRight;
+        }
+
+        return (static_cast<uint64_t>(right) << 32) | left;
+    }
+
+    /**
+     * @brief Función de Feistel sobre enteros: expansión, XOR con la subclave y S-Box + P combinadas.
+     * @param right El semibloque derecho de 32 bits.
+     * @param subkey La subclave de 48 bits.
+     * @return El resultado de 32 bits de la función de Feistel.
+     */
+    static uint32_t
+    feistelFast(uint32_t right, uint64_t subkey) {
+        return feistelFast(fastTables(), right, subkey);
+    }
+
+    /**
+     * @brief Expande un semibloque de 32 bits a 48 bits mediante tablas (equivalente a expand()).
+     */
+    static uint64_t
+    expandFast(uint32_t right) {
+        return expandFast(fastTables(), right);
+    }
+
     /**
      * @brief Convierte un string (bloque de 8 caracteres) a un bitset de 64 bits.
      * @param block El string de entrada (se esperan 8 caracteres).
@@ -191,8 +318,87 @@ public:
     }
 
 private:
+    /**
+     * @brief Tablas de la ruta rápida, derivadas de las funciones con bitset para que ambas coincidan.
+     * sp combina la S-Box y la permutación P de cada grupo de 6 bits.
+     */
+    struct FastTables {
+        uint64_t ip[8][256];
+        uint64_t fp[8][256];
+        uint64_t expansion[4][256];
+        uint32_t sp[8][64];
+    };
+
+    static const FastTables&
+    fastTables() {
+        static const std::unique_ptr<const FastTables> tables = buildFastTables();
+        return *tables;
+    }
+
+    static std::unique_ptr<const FastTables>
+    buildFastTables() {
+        DES reference;
+        auto tables = std::make_unique<FastTables>();
+
+        for (int byte = 0; byte < 8; ++byte) {
+            for (uint64_t value = 0; value < 256; ++value) {
+                std::bitset<64> input(value << (byte * 8));
+                tables->ip[byte][value] = reference.iPermutation(input).to_ullong();
+                tables->fp[byte][value] = reference.fPermutation(input).to_ullong();
+            }
+        }
+
+        for (int byte = 0; byte < 4; ++byte) {
+            for (uint32_t value = 0; value < 256; ++value) {
+                std::bitset<32> half(value << (byte * 8));
+                tables->expansion[byte][value] = reference.expand(half).to_ullong();
+            }
+        }
+
+        for (int box = 0; box < 8; ++box) {
+            for (uint64_t value = 0; value < 64; ++value) {
+                auto substituted = reference.substitute(std::bitset<48>(value << (box * 6)));
+                std::bitset<32> boxOutput;
+                for (int j = 0; j < 4; ++j) {
+                    boxOutput[box * 4 + j] = substituted[box * 4 + j];
+                }
+                tables->sp[box][value] = static_cast<uint32_t>(reference.permutedP(boxOutput).to_ulong());
+            }
+        }
+        return tables;
+    }
+
+    static uint64_t
+    permuteBytes(const uint64_t (&table)[8][256], uint64_t input) {
+        uint64_t output = 0;
+        for (int byte = 0; byte < 8; ++byte) {
+            output |= table[byte][(input >> (byte * 8)) & 0xFF];
+        }
+        return output;
+    }
+
+    static uint64_t
+    expandFast(const FastTables& tables, uint32_t right) {
+        return tables.expansion[0][right & 0xFF] |
+            tables.expansion[1][(right >> 8) & 0xFF] |
+            tables.expansion[2][(right >> 16) & 0xFF] |
+            tables.expansion[3][right >> 24];
+    }
+
+    static uint32_t
+    feistelFast(const FastTables& tables, uint32_t right, uint64_t subkey) {
+        uint64_t xored = expandFast(tables, right) ^ subkey;
+
+        uint32_t output = 0;
+        for (int box = 0; box < 8; ++box) {
+            output |= tables.sp[box][(xored >> (box * 6)) & 0x3F];
+        }
+        return output;
+    }
+
     std::bitset<64> key;
     std::vector<std::bitset<48>> subkeys;
+    FastSchedule fastSubkeys{};
 
     // Tabla de expansi�n simplificada (E)
     const int EXPANSION_TABLE[48] = {
@@ -0,0 +1,317 @@
+#pragma once
+#include "ReducedDES.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Pares de cifrados obtenidos con texto plano elegido: C = E(P) y C' = E(P ^ ΔP).
+ * Se guardan como estructura de arreglos para recorrerlos de forma secuencial.
+ */
+struct DifferentialPairs {
+    uint64_t inputDifference = 0;
+    std::vector<uint64_t> ciphertexts;
+    std::vector<uint64_t> partnerCiphertexts;
+};
+
+/**
+ * @brief Característica diferencial esperada tras Rounds-1 rondas: diferencias de (L, R).
+ */
+struct DifferentialCharacteristic {
+    uint64_t inputDifference = 0;
+    uint32_t leftDifference = 0;
+    uint32_t rightDifference = 0;
+    double probability = 0.0;
+};
+
+/**
+ * @brief Resultado del conteo de subclaves candidatas de la última ronda.
+ * Cada par vota por igual a k y a k ^ Δentrada, así que una sola característica deja al menos dos
+ * candidatas por caja; una caja sin diferencia de entrada no recibe votos útiles y conserva las 64.
+ */
+struct DifferentialAttackResult {
+    std::array<std::array<uint64_t, 64>, 8> counts{};
+    // Subclaves de 6 bits empatadas con el máximo de votos en cada caja.
+    std::array<std::vector<uint8_t>, 8> candidates{};
+    // Bits de las cajas con una sola candidata; recoveredMask indica cuáles son válidos.
+    uint64_t recoveredSubkey = 0;
+    uint64_t recoveredMask = 0;
+    uint64_t pairsUsed = 0;
+    uint64_t pairsFiltered = 0;
+    // Cajas cuyas candidatas son menos de 64.
+    uint8_t informativeBoxes = 0;
+
+    bool
+    recovered(int box) const {
+        return candidates[box].size() == 1;
+    }
+
+    bool
+    informative(int box) const {
+        return candidates[box].size() < 64;
+    }
+};
+
+/**
+ * @brief Criptoanálisis diferencial del DES simplificado (una sola SBOX, rondas reducidas).
+ * Incluye la tabla de distribución de diferencias, la generación de pares con texto plano elegido
+ * y el ataque a la subclave de la última ronda con contadores por hilo que se suman al final.
+ */
+class DESDifferential {
+public:
+    using DifferenceTable = std::array<std::array<uint32_t, 16>, 64>;
+
+    DESDifferential(unsigned int threads = 0) :
+        threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+
+    ~DESDifferential() = default;
+
+    /**
+     * @brief Calcula la tabla de distribución de diferencias (DDT) de la SBOX.
+     * @return ddt[Δentrada][Δsalida] = número de entradas x con S(x) ^ S(x ^ Δentrada) = Δsalida.
+     */
+    static DifferenceTable
+    differenceDistributionTable() {
+        DifferenceTable table{};
+        const auto& sbox = DESAnalysis::sbox();
+        for (int delta_in = 0; delta_in < 64; ++delta_in) {
+            for (int x = 0; x < 64; ++x) {
+                ++table[delta_in][sbox[x] ^ sbox[x ^ delta_in]];
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief Imprime la DDT en formato de tabla.
+     */
+    static void
+    printDifferenceTable(const DifferenceTable& table) {
+        std::cout << "DDT de la SBOX (filas: Δentrada, columnas: Δsalida)" << std::endl;
+        for (int delta_in = 0; delta_in < 64; ++delta_in) {
+            std::cout << std::setw(2) << std::setfill(' ') << delta_in << ":";
+            for (int delta_out = 0; delta_out < 16; ++delta_out) {
+                std::cout << std::setw(3) << table[delta_in][delta_out];
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    /**
+     * @brief Genera pares de cifrados con texto plano elegido usando la clave secreta (oráculo de laboratorio).
+     * @param key La clave DES del oráculo.
+     * @param inputDifference La diferencia ΔP entre los dos textos planos de cada par.
+     * @param count Número de pares.
+     * @param seed Semilla para los textos planos aleatorios.
+     */
+    template <int Rounds>
+    DifferentialPairs
+    generatePairs(uint64_t key, uint64_t inputDifference, size_t count, uint64_t seed = 1) const {
+        DifferentialPairs pairs;
+        pairs.inputDifference = inputDifference;
+        pairs.ciphertexts.resize(count);
+        pairs.partnerCiphertexts.resize(count);
+        const DES::FastSchedule schedule = DES::fastSchedule(key);
+
+        runParallel(count, [&](size_t begin, size_t end, unsigned int worker) {
+            std::mt19937_64 random(seed + worker * 0x9E3779B97F4A7C15ULL);
+            for (size_t i = begin; i < end; ++i) {
+                uint64_t plaintext = random();
+                pairs.ciphertexts[i] = ReducedDES<Rounds>::encode(plaintext, schedule);
+                pairs.partnerCiphertexts[i] = ReducedDES<Rounds>::encode(plaintext ^ inputDifference, schedule);
+            }
+        });
+        return pairs;
+    }
+
+    /**
+     * @brief Busca empíricamente la diferencia de salida más probable tras 'Rounds' rondas.
+     * Sirve para encontrar una característica de Rounds rondas con la que atacar Rounds + 1 rondas.
+     * @param inputDifference La diferencia ΔP.
+     * @param samples Número de pares a muestrear (con claves aleatorias).
+     * @param seed Semilla.
+     */
+    template <int Rounds>
+    DifferentialCharacteristic
+    findCharacteristic(uint64_t inputDifference, size_t samples, uint64_t seed = 1) const {
+        std::vector<std::unordered_map<uint64_t, uint64_t>> histograms(threads_);
+        runParallel(samples, [&](size_t begin, size_t end, unsigned int worker) {
+            std::mt19937_64 random(seed + worker * 0x9E3779B97F4A7C15ULL);
+            auto& histogram = histograms[worker];
+            for (size_t i = begin; i < end; ++i) {
+                const DES::FastSchedule schedule = DES::fastSchedule(random());
+                uint64_t plaintext = random();
+                uint64_t difference = ReducedDES<Rounds>::state(plaintext, schedule) ^
+                    ReducedDES<Rounds>::state(plaintext ^ inputDifference, schedule);
+                ++histogram[difference];
+            }
+        });
+
+        std::unordered_map<uint64_t, uint64_t> merged;
+        for (const auto& histogram : histograms) {
+            for (const auto& entry : histogram) {
+                merged[entry.first] += entry.second;
+            }
+        }
+
+        DifferentialCharacteristic best;
+        best.inputDifference = inputDifference;
+        uint64_t best_count = 0;
+        for (const auto& entry : merged) {
+            if (entry.second > best_count) {
+                best_count = entry.second;
+                best.leftDifference = static_cast<uint32_t>(entry.first >> 32);
+                best.rightDifference = static_cast<uint32_t>(entry.first);
+            }
+        }
+        best.probability = samples == 0 ? 0.0 : static_cast<double>(best_count) / samples;
+        return best;
+    }
+
+    /**
+     * @brief Ataca la subclave de la última ronda contando, para cada caja, las subclaves de 6 bits
+     * compatibles con la característica de las rondas anteriores.
+     * Los pares cuya mitad derecha no coincide con la característica se descartan, y para cada par
+     * solo se recorren las entradas permitidas por la DDT (no las 64 subclaves).
+     * @param pairs Pares generados con la diferencia de la característica.
+     * @param characteristic Diferencias esperadas (ΔL, ΔR) antes de la última ronda.
+     * @return Contadores por caja y subclave, las candidatas empatadas de cada caja y los bits de las
+     * cajas resueltas (una sola candidata).
+     */
+    DifferentialAttackResult
+    attackLastRound(const DifferentialPairs& pairs, const DifferentialCharacteristic& characteristic) const {
+        const auto& solutions = differenceSolutions();
+        const size_t count = pairs.ciphertexts.size();
+        std::vector<DifferentialAttackResult> partial(threads_);
+
+        runParallel(count, [&](size_t begin, size_t end, unsigned int worker) {
+            DifferentialAttackResult& local = partial[worker];
+            for (size_t i = begin; i < end; ++i) {
+                // Deshace FP (IP = FP^-1): el cifrado es (R_n, L_n) con L_n = R_{n-1}.
+                uint64_t c1 = DES::iPermutationFast(pairs.ciphertexts[i]);
+                uint64_t c2 = DES::iPermutationFast(pairs.partnerCiphertexts[i]);
+                uint32_t r_prev1 = static_cast<uint32_t>(c1);
+                uint32_t r_prev2 = static_cast<uint32_t>(c2);
+                ++local.pairsUsed;
+                if ((r_prev1 ^ r_prev2) != characteristic.rightDifference) {
+                    continue;
+                }
+                ++local.pairsFiltered;
+
+                uint32_t f_difference = static_cast<uint32_t>((c1 ^ c2) >> 32) ^ characteristic.leftDifference;
+                uint32_t s_difference = DESAnalysis::inversePermuteP(f_difference);
+                uint64_t e1 = DES::expandFast(r_prev1);
+                uint64_t e2 = DES::expandFast(r_prev2);
+
+                for (int box = 0; box < 8; ++box) {
+                    uint8_t in1 = static_cast<uint8_t>((e1 >> (box * 6)) & 0x3F);
+                    uint8_t delta_in = static_cast<uint8_t>(in1 ^ ((e2 >> (box * 6)) & 0x3F));
+                    uint8_t delta_out = static_cast<uint8_t>((s_difference >> (box * 4)) & 0xF);
+                    for (uint8_t x : solutions[delta_in][delta_out]) {
+                        ++local.counts[box][in1 ^ x];
+                    }
+                }
+            }
+        });
+
+        DifferentialAttackResult result;
+        for (const auto& local : partial) {
+            result.pairsUsed += local.pairsUsed;
+            result.pairsFiltered += local.pairsFiltered;
+            for (int box = 0; box < 8; ++box) {
+                for (int guess = 0; guess < 64; ++guess) {
+                    result.counts[box][guess] += local.counts[box][guess];
+                }
+            }
+        }
+
+        for (int box = 0; box < 8; ++box) {
+            const auto& votes = result.counts[box];
+            const uint64_t best = *std::max_element(votes.begin(), votes.end());
+            for (int guess = 0; guess < 64; ++guess) {
+                if (votes[guess] == best) {
+                    result.candidates[box].push_back(static_cast<uint8_t>(guess));
+                }
+            }
+        }
+        resolveBoxes(result);
+        return result;
+    }
+
+    /**
+     * @brief Combina los resultados de dos características: en cada caja quedan las candidatas de ambas.
+     * Con diferencias de entrada distintas en una caja, la pareja k ^ Δentrada se descarta y la caja
+     * queda resuelta.
+     */
+    static DifferentialAttackResult
+    intersect(const DifferentialAttackResult& first, const DifferentialAttackResult& second) {
+        DifferentialAttackResult result;
+        result.pairsUsed = first.pairsUsed + second.pairsUsed;
+        result.pairsFiltered = first.pairsFiltered + second.pairsFiltered;
+        for (int box = 0; box < 8; ++box) {
+            for (int guess = 0; guess < 64; ++guess) {
+                result.counts[box][guess] = first.counts[box][guess] + second.counts[box][guess];
+            }
+            std::set_intersection(first.candidates[box].begin(), first.candidates[box].end(),
+                                  second.candidates[box].begin(), second.candidates[box].end(),
+                                  std::back_inserter(result.candidates[box]));
+        }
+        resolveBoxes(result);
+        return result;
+    }
+
+private:
+    /**
+     * @brief Cuenta las cajas informativas y compone la subclave con las cajas de una sola candidata.
+     */
+    static void
+    resolveBoxes(DifferentialAttackResult& result) {
+        result.informativeBoxes = 0;
+        result.recoveredSubkey = 0;
+        result.recoveredMask = 0;
+        for (int box = 0; box < 8; ++box) {
+            if (result.informative(box)) {
+                ++result.informativeBoxes;
+            }
+            if (result.recovered(box)) {
+                result.recoveredSubkey |= static_cast<uint64_t>(result.candidates[box].front()) << (box * 6);
+                result.recoveredMask |= 0x3FULL << (box * 6);
+            }
+        }
+    }
+
+    using SolutionTable = std::array<std::array<std::vector<uint8_t>, 16>, 64>;
+
+    /**
+     * @brief Para cada (Δentrada, Δsalida), las entradas x con S(x) ^ S(x ^ Δentrada) = Δsalida.
+     */
+    static const SolutionTable&
+    differenceSolutions() {
+        static const SolutionTable table = []() {
+            SolutionTable result;
+            const auto& sbox = DESAnalysis::sbox();
+            for (int delta_in = 0; delta_in < 64; ++delta_in) {
+                for (int x = 0; x < 64; ++x) {
+                    result[delta_in][sbox[x] ^ sbox[x ^ delta_in]].push_back(static_cast<uint8_t>(x));
+                }
+            }
+            return result;
+        }();
+        return table;
+    }
+
+    template <typename Work>
+    void
+    runParallel(size_t count, Work work) const {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads_; ++t) {
+            size_t begin = count * t / threads_;
+            size_t end = count * (t + 1) / threads_;
+            workers.emplace_back(work, begin, end, t);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    unsigned int threads_;
+};
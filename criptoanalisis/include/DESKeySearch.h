@@ -0,0 +1,359 @@
+#pragma once
+#include "DES.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Par de bloques conocidos (texto plano y su cifrado) para un ataque de texto plano conocido.
+ */
+struct DESKnownPair {
+    uint64_t plaintext;
+    uint64_t ciphertext;
+};
+
+/**
+ * @brief Describe un espacio de claves DES restringido.
+ * - Mask: bits conocidos fijos y una máscara de bits desconocidos (también cubre rangos de bits).
+ * - Charset: claves derivadas de contraseñas de longitud fija sobre un alfabeto.
+ * En ambos casos las claves se enumeran por índice, y [begin, end) permite buscar solo una parte.
+ */
+struct DESKeySpace {
+    enum class Kind { Mask, Charset };
+
+    Kind kind = Kind::Mask;
+    uint64_t knownBits = 0;
+    uint64_t unknownMask = 0;
+    std::string charset;
+    size_t passwordLength = 0;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+
+    /**
+     * @brief Crea un espacio de claves a partir de una clave parcial y la máscara de bits desconocidos.
+     * Los bits desconocidos que DES no usa se descartan, ya que no cambian el resultado.
+     * @param knownKey La clave con los bits conocidos (los desconocidos se ignoran).
+     * @param mask Los bits desconocidos de la clave.
+     */
+    static DESKeySpace
+    fromMask(uint64_t knownKey, uint64_t mask) {
+        DESKeySpace space;
+        space.kind = Kind::Mask;
+        space.unknownMask = mask & DES::EFFECTIVE_KEY_MASK;
+        space.knownBits = knownKey & ~space.unknownMask;
+        space.end = space.fullSize();
+        return space;
+    }
+
+    /**
+     * @brief Crea un espacio de claves donde los bits [lowBit, highBit) son desconocidos.
+     * @param knownKey La clave con los bits conocidos.
+     * @param lowBit El primer bit desconocido (0 = bit menos significativo).
+     * @param highBit El bit siguiente al último desconocido.
+     */
+    static DESKeySpace
+    fromBitRange(uint64_t knownKey, int lowBit, int highBit) {
+        if (lowBit < 0 || highBit > 64 || lowBit >= highBit) {
+            throw std::invalid_argument("Rango de bits inválido para el espacio de claves DES.");
+        }
+        uint64_t width = static_cast<uint64_t>(highBit - lowBit);
+        uint64_t mask = (width == 64 ? ~0ULL : ((1ULL << width) - 1)) << lowBit;
+        return fromMask(knownKey, mask);
+    }
+
+    /**
+     * @brief Crea un espacio de claves derivadas de contraseñas (hasta 8 caracteres) sobre un alfabeto.
+     * La clave es la contraseña empaquetada igual que DES::stringToBitset64().
+     * @param alphabet Los caracteres posibles de la contraseña.
+     * @param length La longitud de la contraseña.
+     */
+    static DESKeySpace
+    fromCharset(const std::string& alphabet, size_t length) {
+        if (alphabet.empty() || length == 0 || length > 8) {
+            throw std::invalid_argument("Alfabeto vacío o longitud de contraseña fuera de 1..8.");
+        }
+        DESKeySpace space;
+        space.kind = Kind::Charset;
+        space.charset = alphabet;
+        space.passwordLength = length;
+        space.end = space.fullSize();
+        return space;
+    }
+
+    /**
+     * @brief Restringe la búsqueda a los índices [first, last) del espacio (útil para repartir entre equipos).
+     */
+    DESKeySpace
+    withRange(uint64_t first, uint64_t last) const {
+        DESKeySpace copy = *this;
+        copy.begin = std::min(first, fullSize());
+        copy.end = std::max(copy.begin, std::min(last, fullSize()));
+        return copy;
+    }
+
+    /**
+     * @brief Número total de claves del espacio, ignorando [begin, end).
+     */
+    uint64_t
+    fullSize() const {
+        if (kind == Kind::Charset) {
+            uint64_t total = 1;
+            for (size_t i = 0; i < passwordLength; ++i) {
+                if (total > std::numeric_limits<uint64_t>::max() / charset.size()) {
+                    throw std::overflow_error("El espacio de contraseñas no cabe en 64 bits.");
+                }
+                total *= charset.size();
+            }
+            return total;
+        }
+        int bits = static_cast<int>(std::bitset<64>(unknownMask).count());
+        if (bits >= 64) {
+            throw std::overflow_error("El espacio de claves no cabe en 64 bits.");
+        }
+        return 1ULL << bits;
+    }
+
+    /**
+     * @brief Número de claves a recorrer.
+     */
+    uint64_t
+    size() const {
+        return end - begin;
+    }
+
+    /**
+     * @brief Devuelve la clave con índice 'index' dentro del espacio completo.
+     */
+    uint64_t
+    keyAt(uint64_t index) const {
+        if (kind == Kind::Charset) {
+            std::string password(passwordLength, '\0');
+            for (size_t i = passwordLength; i-- > 0;) {
+                password[i] = charset[index % charset.size()];
+                index /= charset.size();
+            }
+            return passwordToKey(password);
+        }
+        uint64_t key = knownBits;
+        for (uint64_t bits = unknownMask; bits != 0 && index != 0; bits &= bits - 1, index >>= 1) {
+            if (index & 1) {
+                key |= bits & (~bits + 1);
+            }
+        }
+        return key;
+    }
+
+    /**
+     * @brief Recorre claves consecutivas del espacio sin recalcular cada una desde su índice.
+     */
+    class Cursor {
+    public:
+        Cursor(const DESKeySpace& space, uint64_t index) :
+            space_(space), key_(space.keyAt(index)) {
+            if (space_.kind == Kind::Charset) {
+                digits_.assign(space_.passwordLength, 0);
+                for (size_t i = space_.passwordLength; i-- > 0;) {
+                    digits_[i] = index % space_.charset.size();
+                    index /= space_.charset.size();
+                }
+            }
+        }
+
+        uint64_t
+        key() const {
+            return key_;
+        }
+
+        void
+        advance() {
+            if (space_.kind == Kind::Mask) {
+                uint64_t free_bits = ((key_ | ~space_.unknownMask) + 1) & space_.unknownMask;
+                key_ = space_.knownBits | free_bits;
+                return;
+            }
+            for (size_t i = digits_.size(); i-- > 0;) {
+                size_t shift = (7 - i) * 8;
+                digits_[i] = (digits_[i] + 1) % space_.charset.size();
+                key_ = (key_ & ~(0xFFULL << shift)) |
+                    (static_cast<uint64_t>(static_cast<unsigned char>(space_.charset[digits_[i]])) << shift);
+                if (digits_[i] != 0) {
+                    break;
+                }
+            }
+        }
+
+    private:
+        const DESKeySpace& space_;
+        uint64_t key_;
+        std::vector<size_t> digits_;
+    };
+
+    /**
+     * @brief Indica si el espacio es cerrado bajo complemento de los bits efectivos de la clave,
+     * requisito para aprovechar la propiedad de complementación de DES.
+     */
+    bool
+    isComplementClosed() const {
+        return kind == Kind::Mask && begin == 0 && end == fullSize() &&
+            (unknownMask & DES::EFFECTIVE_KEY_MASK) == DES::EFFECTIVE_KEY_MASK;
+    }
+
+    /**
+     * @brief Empaqueta una contraseña de hasta 8 caracteres como clave de 64 bits (big-endian).
+     */
+    static uint64_t
+    passwordToKey(const std::string& password) {
+        uint64_t key = 0;
+        for (size_t i = 0; i < password.size() && i < 8; ++i) {
+            key |= static_cast<uint64_t>(static_cast<unsigned char>(password[i])) << ((7 - i) * 8);
+        }
+        return key;
+    }
+};
+
+/**
+ * @brief Resultado de una búsqueda de clave DES.
+ */
+struct DESKeySearchResult {
+    bool found = false;
+    uint64_t key = 0;
+    uint64_t keysTested = 0;
+    double seconds = 0.0;
+    bool usedComplementation = false;
+};
+
+/**
+ * @brief Búsqueda exhaustiva multihilo de claves DES con texto plano conocido.
+ * Cada hilo toma bloques de índices del espacio de claves; el primer par se compara en cada clave
+ * y el resto de pares solo se verifica cuando el primero coincide.
+ */
+class DESKeySearch {
+public:
+    DESKeySearch(unsigned int threads = 0) :
+        threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+
+    ~DESKeySearch() = default;
+
+    /**
+     * @brief Busca una clave que cifre todos los pares conocidos.
+     * Si el espacio es cerrado bajo complemento y entre los pares hay uno con texto plano P y otro con ~P,
+     * se usa la propiedad E_{~k}(~P) = ~E_k(P): cada cifrado prueba k y ~k, y solo se recorre la mitad del espacio.
+     * @param pairs Los pares (texto plano, cifrado) conocidos. Debe haber al menos uno.
+     * @param space El espacio de claves a recorrer.
+     * @return El resultado de la búsqueda (clave encontrada, claves probadas y tiempo).
+     */
+    DESKeySearchResult
+    search(const std::vector<DESKnownPair>& pairs, const DESKeySpace& space) const {
+        if (pairs.empty()) {
+            throw std::invalid_argument("Se necesita al menos un par texto plano/cifrado.");
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+        DESKeySearchResult result;
+
+        // Busca un par complementario del primero: (P, C1) y (~P, C2).
+        const DESKnownPair& first = pairs[0];
+        const DESKnownPair* complement = nullptr;
+        for (const auto& pair : pairs) {
+            if (pair.plaintext == ~first.plaintext) {
+                complement = &pair;
+                break;
+            }
+        }
+
+        DESKeySpace effective = space;
+        uint64_t pivot = 0;
+        if (complement != nullptr && space.isComplementClosed()) {
+            // Se fija a 0 el bit desconocido más alto: cada clave probada cubre también a su complemento.
+            pivot = 1ULL << (63 - countLeadingZeros(space.unknownMask));
+            effective.unknownMask &= ~pivot;
+            effective.end = effective.fullSize();
+            result.usedComplementation = true;
+        }
+
+        std::atomic<uint64_t> next_chunk{effective.begin};
+        std::atomic<uint64_t> tested{0};
+        std::atomic<bool> found{false};
+        std::mutex result_mutex;
+
+        auto worker = [&]() {
+            uint64_t local_tested = 0;
+            while (!found.load(std::memory_order_relaxed)) {
+                uint64_t chunk_begin = next_chunk.fetch_add(kChunkSize);
+                if (chunk_begin >= effective.end) {
+                    break;
+                }
+                uint64_t chunk_end = std::min(effective.end, chunk_begin + kChunkSize);
+
+                DESKeySpace::Cursor cursor(effective, chunk_begin);
+                for (uint64_t index = chunk_begin; index < chunk_end; ++index, cursor.advance()) {
+                    uint64_t key = cursor.key();
+                    uint64_t cipher = DES::encodeWithSchedule(first.plaintext, DES::fastSchedule(key));
+                    ++local_tested;
+
+                    uint64_t candidate = 0;
+                    bool hit = false;
+                    if (cipher == first.ciphertext && verify(pairs, key)) {
+                        candidate = key;
+                        hit = true;
+                    } else if (complement != nullptr && pivot != 0 && cipher == ~complement->ciphertext &&
+                        verify(pairs, ~key)) {
+                        // Solo los bits efectivos se complementan; el resto conserva los bits conocidos.
+                        candidate = (~key & DES::EFFECTIVE_KEY_MASK) | (key & ~DES::EFFECTIVE_KEY_MASK);
+                        hit = true;
+                    }
+
+                    if (hit) {
+                        std::lock_guard<std::mutex> lock(result_mutex);
+                        if (!result.found) {
+                            result.found = true;
+                            result.key = candidate;
+                        }
+                        found.store(true);
+                        break;
+                    }
+                }
+            }
+            tested.fetch_add(local_tested);
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int i = 0; i < threads_; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+
+        result.keysTested = tested.load();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+private:
+    static constexpr uint64_t kChunkSize = 1 << 14;
+
+    /**
+     * @brief Comprueba una clave candidata contra todos los pares conocidos.
+     */
+    static bool
+    verify(const std::vector<DESKnownPair>& pairs, uint64_t key) {
+        DES::FastSchedule schedule = DES::fastSchedule(key);
+        for (const auto& pair : pairs) {
+            if (DES::encodeWithSchedule(pair.plaintext, schedule) != pair.ciphertext) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static int
+    countLeadingZeros(uint64_t value) {
+        int count = 0;
+        for (uint64_t bit = 1ULL << 63; bit != 0 && (value & bit) == 0; bit >>= 1) {
+            ++count;
+        }
+        return count;
+    }
+
+    unsigned int threads_;
+};
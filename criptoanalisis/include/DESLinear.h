@@ -0,0 +1,347 @@
+#pragma once
+#include "DESKeySearch.h"
+#include "ReducedDES.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Conjunto de pares de texto plano conocido en formato "bit-sliced" (estructura de arreglos):
+ * para cada bit del bloque (tras IP) hay un plano de palabras de 64 bits, y el bit j de la palabra w
+ * corresponde a la muestra 64 * w + j. Así la paridad de una máscara se calcula para 64 muestras
+ * a la vez con XOR de planos, y se cuenta con popcount.
+ */
+struct LinearSamples {
+    size_t count = 0;
+    std::array<std::vector<uint64_t>, 64> plaintextPlanes;
+    std::array<std::vector<uint64_t>, 64> ciphertextPlanes;
+
+    size_t
+    words() const {
+        return (count + 63) / 64;
+    }
+
+    /**
+     * @brief Máscara de muestras válidas de la palabra 'word' (la última puede estar incompleta).
+     */
+    uint64_t
+    validMask(size_t word) const {
+        size_t remaining = count - word * 64;
+        return remaining >= 64 ? ~0ULL : ((1ULL << remaining) - 1);
+    }
+
+    /**
+     * @brief Construye el conjunto a partir de pares (texto plano, cifrado) cualesquiera.
+     */
+    static LinearSamples
+    fromPairs(const std::vector<DESKnownPair>& pairs) {
+        LinearSamples samples;
+        samples.resize(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            samples.set(i, pairs[i].plaintext, pairs[i].ciphertext);
+        }
+        return samples;
+    }
+
+    void
+    resize(size_t samples) {
+        count = samples;
+        for (int bit = 0; bit < 64; ++bit) {
+            plaintextPlanes[bit].assign(words(), 0);
+            ciphertextPlanes[bit].assign(words(), 0);
+        }
+    }
+
+    /**
+     * @brief Guarda la muestra 'index' (deshaciendo FP del cifrado y aplicando IP al texto plano).
+     */
+    void
+    set(size_t index, uint64_t plaintext, uint64_t ciphertext) {
+        uint64_t p = DES::iPermutationFast(plaintext);
+        uint64_t c = DES::iPermutationFast(ciphertext);
+        size_t word = index / 64;
+        uint64_t bit_in_word = 1ULL << (index % 64);
+        for (int bit = 0; bit < 64; ++bit) {
+            if ((p >> bit) & 1) {
+                plaintextPlanes[bit][word] |= bit_in_word;
+            }
+            if ((c >> bit) & 1) {
+                ciphertextPlanes[bit][word] |= bit_in_word;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Aproximación lineal para el ataque a la última ronda:
+ * α·(L0,R0) ⊕ βL·L_{n-1} ⊕ βR·R_{n-1} = γ·K.
+ * βL debe afectar a una sola caja de la última ronda (tras deshacer P).
+ */
+struct LinearApproximation {
+    uint64_t plaintextMask = 0;
+    uint32_t leftMask = 0;
+    uint32_t rightMask = 0;
+};
+
+/**
+ * @brief Resultado del ataque lineal a 6 bits de la subclave de la última ronda.
+ */
+struct LinearAttackResult {
+    int box = -1;
+    uint8_t bestGuess = 0;
+    double bestBias = 0.0;
+    std::array<double, 64> biases{};
+    size_t samples = 0;
+};
+
+/**
+ * @brief Criptoanálisis lineal (Matsui) del DES simplificado con rondas reducidas.
+ * Las paridades se evalúan sobre planos de bits con AND/XOR y popcount, 64 muestras por palabra,
+ * y cada hilo acumula un histograma (entrada de la caja, paridad conocida) que luego se combina
+ * para puntuar las 64 subclaves candidatas sin volver a recorrer las muestras.
+ */
+class DESLinear {
+public:
+    using ApproximationTable = std::array<std::array<int, 16>, 64>;
+
+    DESLinear(unsigned int threads = 0) :
+        threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+
+    ~DESLinear() = default;
+
+    /**
+     * @brief Calcula la tabla de aproximaciones lineales (LAT) de la SBOX.
+     * @return lat[máscara entrada][máscara salida] = #{x : a·x = b·S(x)} - 32.
+     */
+    static ApproximationTable
+    linearApproximationTable() {
+        ApproximationTable table{};
+        const auto& sbox = DESAnalysis::sbox();
+        for (int in_mask = 0; in_mask < 64; ++in_mask) {
+            for (int out_mask = 0; out_mask < 16; ++out_mask) {
+                int matches = 0;
+                for (int x = 0; x < 64; ++x) {
+                    if (parity(static_cast<uint64_t>(x & in_mask)) == parity(static_cast<uint64_t>(sbox[x] & out_mask))) {
+                        ++matches;
+                    }
+                }
+                table[in_mask][out_mask] = matches - 32;
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief Genera pares de texto plano conocido cifrados con 'Rounds' rondas (oráculo de laboratorio).
+     */
+    template <int Rounds>
+    LinearSamples
+    generateSamples(uint64_t key, size_t count, uint64_t seed = 1) const {
+        LinearSamples samples;
+        samples.resize(count);
+        const DES::FastSchedule schedule = DES::fastSchedule(key);
+        const size_t words = samples.words();
+
+        // Cada hilo escribe palabras completas, así que no hay conflictos entre hilos.
+        runParallel(words, [&](size_t begin, size_t end, unsigned int worker) {
+            std::mt19937_64 random(seed + worker * 0x9E3779B97F4A7C15ULL);
+            for (size_t word = begin; word < end; ++word) {
+                for (size_t i = word * 64; i < std::min(count, word * 64 + 64); ++i) {
+                    uint64_t plaintext = random();
+                    samples.set(i, plaintext, ReducedDES<Rounds>::encode(plaintext, schedule));
+                }
+            }
+        });
+        return samples;
+    }
+
+    /**
+     * @brief Mide el sesgo de α·P ⊕ β·C sobre el conjunto (algoritmo 1 de Matsui).
+     * @param samples Las muestras.
+     * @param plaintextMask Máscara α sobre (L0, R0).
+     * @param ciphertextMask Máscara β sobre el cifrado tras deshacer FP.
+     * @return T/N - 1/2, donde T es el número de muestras con paridad 0.
+     */
+    double
+    estimateBias(const LinearSamples& samples, uint64_t plaintextMask, uint64_t ciphertextMask) const {
+        if (samples.count == 0) {
+            return 0.0;
+        }
+        std::vector<uint64_t> ones(threads_, 0);
+        runParallel(samples.words(), [&](size_t begin, size_t end, unsigned int worker) {
+            uint64_t local = 0;
+            for (size_t word = begin; word < end; ++word) {
+                uint64_t parity_word = maskedParity(samples.plaintextPlanes, plaintextMask, word) ^
+                    maskedParity(samples.ciphertextPlanes, ciphertextMask, word);
+                local += popcount(parity_word & samples.validMask(word));
+            }
+            ones[worker] = local;
+        });
+        uint64_t total_ones = std::accumulate(ones.begin(), ones.end(), uint64_t(0));
+        return static_cast<double>(samples.count - total_ones) / samples.count - 0.5;
+    }
+
+    /**
+     * @brief Mide con claves aleatorias el sesgo de una aproximación sobre 'Rounds' rondas
+     * (estado interno sin intercambio final), para elegir aproximaciones antes del ataque.
+     */
+    template <int Rounds>
+    double
+    measureBias(uint64_t plaintextMask, uint64_t stateMask, size_t count, uint64_t seed = 1) const {
+        std::vector<uint64_t> zeros(threads_, 0);
+        runParallel(count, [&](size_t begin, size_t end, unsigned int worker) {
+            std::mt19937_64 random(seed + worker * 0x9E3779B97F4A7C15ULL);
+            const DES::FastSchedule schedule = DES::fastSchedule(random());
+            uint64_t local = 0;
+            for (size_t i = begin; i < end; ++i) {
+                uint64_t plaintext = random();
+                uint64_t state = ReducedDES<Rounds>::state(plaintext, schedule);
+                if (parity(DES::iPermutationFast(plaintext) & plaintextMask) == parity(state & stateMask)) {
+                    ++local;
+                }
+            }
+            zeros[worker] = local;
+        });
+        uint64_t total = std::accumulate(zeros.begin(), zeros.end(), uint64_t(0));
+        return count == 0 ? 0.0 : static_cast<double>(total) / count - 0.5;
+    }
+
+    /**
+     * @brief Ataque a la última ronda (algoritmo 2 de Matsui) para los 6 bits de subclave de una caja.
+     * El cifrado (tras deshacer FP) es (R_n, L_n) con L_n = R_{n-1} y L_{n-1} = R_n ⊕ f(R_{n-1}, K):
+     * βL·L_{n-1} = βL·R_n ⊕ b·S(E(R_{n-1})_caja ⊕ g), donde b = P^-1(βL) restringido a la caja.
+     * @param samples Las muestras de texto plano conocido.
+     * @param approximation La aproximación sobre las primeras n-1 rondas.
+     * @return El sesgo de cada subclave candidata y la de mayor sesgo absoluto.
+     * @throws std::invalid_argument Si βL no afecta exactamente a una caja.
+     */
+    LinearAttackResult
+    attackLastRound(const LinearSamples& samples, const LinearApproximation& approximation) const {
+        uint32_t box_masks = DESAnalysis::inversePermuteP(approximation.leftMask);
+        int box = -1;
+        for (int candidate = 0; candidate < 8; ++candidate) {
+            if ((box_masks >> (candidate * 4)) & 0xF) {
+                if (box != -1) {
+                    throw std::invalid_argument("La máscara βL debe afectar a una sola caja de la última ronda.");
+                }
+                box = candidate;
+            }
+        }
+        if (box == -1) {
+            throw std::invalid_argument("La máscara βL no afecta a ninguna caja de la última ronda.");
+        }
+        const uint8_t out_mask = static_cast<uint8_t>((box_masks >> (box * 4)) & 0xF);
+
+        // Parte conocida: α·P ⊕ βL·R_n ⊕ βR·L_n, con R_n en la mitad alta del cifrado y L_n en la baja.
+        const uint64_t known_cipher_mask = (static_cast<uint64_t>(approximation.leftMask) << 32) |
+            approximation.rightMask;
+
+        // Bits del cifrado (mitad baja, R_{n-1}) que forman la entrada de 6 bits de la caja tras E.
+        std::array<int, 6> input_bits{};
+        for (int k = 0; k < 6; ++k) {
+            for (int bit = 0; bit < 32; ++bit) {
+                if ((DES::expandFast(1u << bit) >> (box * 6 + k)) & 1) {
+                    input_bits[k] = bit;
+                }
+            }
+        }
+
+        using Histogram = std::array<std::array<uint64_t, 2>, 64>;
+        std::vector<Histogram> histograms(threads_);
+        runParallel(samples.words(), [&](size_t begin, size_t end, unsigned int worker) {
+            Histogram& histogram = histograms[worker];
+            for (auto& row : histogram) {
+                row = {0, 0};
+            }
+            std::array<uint64_t, 64> groups{};
+            for (size_t word = begin; word < end; ++word) {
+                uint64_t known = maskedParity(samples.plaintextPlanes, approximation.plaintextMask, word) ^
+                    maskedParity(samples.ciphertextPlanes, known_cipher_mask, word);
+
+                // Reparte las 64 muestras según el valor de 6 bits con un árbol de AND sobre los planos.
+                groups[0] = samples.validMask(word);
+                for (int k = 0; k < 6; ++k) {
+                    uint64_t plane = samples.ciphertextPlanes[input_bits[k]][word];
+                    int width = 1 << k;
+                    for (int value = width - 1; value >= 0; --value) {
+                        groups[value | width] = groups[value] & plane;
+                        groups[value] &= ~plane;
+                    }
+                }
+                for (int value = 0; value < 64; ++value) {
+                    uint64_t ones = popcount(groups[value] & known);
+                    histogram[value][1] += ones;
+                    histogram[value][0] += popcount(groups[value]) - ones;
+                }
+            }
+        });
+
+        Histogram merged{};
+        for (const auto& histogram : histograms) {
+            for (int value = 0; value < 64; ++value) {
+                merged[value][0] += histogram[value][0];
+                merged[value][1] += histogram[value][1];
+            }
+        }
+
+        LinearAttackResult result;
+        result.box = box;
+        result.samples = samples.count;
+        const auto& sbox = DESAnalysis::sbox();
+        for (int guess = 0; guess < 64; ++guess) {
+            uint64_t zeros = 0;
+            for (int value = 0; value < 64; ++value) {
+                int guessed_parity = parity(static_cast<uint64_t>(sbox[value ^ guess] & out_mask));
+                zeros += merged[value][guessed_parity];
+            }
+            result.biases[guess] = samples.count == 0 ? 0.0 : static_cast<double>(zeros) / samples.count - 0.5;
+            if (std::abs(result.biases[guess]) > std::abs(result.bestBias)) {
+                result.bestBias = result.biases[guess];
+                result.bestGuess = static_cast<uint8_t>(guess);
+            }
+        }
+        return result;
+    }
+
+private:
+    static int
+    parity(uint64_t value) {
+        return static_cast<int>(popcount(value) & 1);
+    }
+
+    static uint64_t
+    popcount(uint64_t value) {
+        return std::bitset<64>(value).count();
+    }
+
+    /**
+     * @brief Paridad de los bits de 'mask' para las 64 muestras de la palabra 'word'.
+     */
+    static uint64_t
+    maskedParity(const std::array<std::vector<uint64_t>, 64>& planes, uint64_t mask, size_t word) {
+        uint64_t result = 0;
+        for (; mask != 0; mask &= mask - 1) {
+            int bit = 0;
+            while (((mask >> bit) & 1) == 0) {
+                ++bit;
+            }
+            result ^= planes[bit][word];
+        }
+        return result;
+    }
+
+    template <typename Work>
+    void
+    runParallel(size_t count, Work work) const {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads_; ++t) {
+            size_t begin = count * t / threads_;
+            size_t end = count * (t + 1) / threads_;
+            workers.emplace_back(work, begin, end, t);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    unsigned int threads_;
+};
@@ -0,0 +1,244 @@
+#pragma once
+#include "DESKeySearch.h"
+#include "MappedFile.h"
+#include "ParallelSort.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Resultado de buscar un cifrado en la tabla arcoíris.
+ */
+struct RainbowLookupResult {
+    bool found = false;
+    uint64_t key = 0;
+    uint64_t encryptions = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Tabla arcoíris (compromiso tiempo-memoria) para un espacio de claves DES reducido.
+ * Todas las cadenas parten de un texto plano fijo P: cada eslabón cifra P con la clave actual y
+ * reduce el cifrado (con una función distinta por posición) al índice de la siguiente clave.
+ * Solo se guardan los pares (índice final, índice inicial), ordenados por el final y sin finales repetidos,
+ * en un archivo que se proyecta en memoria para las búsquedas.
+ */
+class DESRainbowTable {
+public:
+    DESRainbowTable() = default;
+    ~DESRainbowTable() = default;
+
+    /**
+     * @brief Genera la tabla en paralelo y la guarda en disco.
+     * @param path Ruta del archivo de salida.
+     * @param space Espacio de claves cubierto (por ejemplo, contraseñas de 6 caracteres).
+     * @param plaintext Bloque de texto plano conocido al que corresponden los cifrados a atacar.
+     * @param chainLength Número de eslabones por cadena.
+     * @param chainCount Número de cadenas a generar.
+     * @param threads Número de hilos (0 = los disponibles en el equipo).
+     * @return El número de cadenas guardadas tras eliminar finales repetidos.
+     */
+    static uint64_t
+    generate(const std::string& path, const DESKeySpace& space, uint64_t plaintext,
+             uint64_t chainLength, uint64_t chainCount, unsigned int threads = 0) {
+        if (space.size() == 0 || chainLength == 0 || chainCount == 0) {
+            throw std::invalid_argument("Parámetros de la tabla arcoíris inválidos.");
+        }
+        if (space.charset.size() > sizeof(Header::charset)) {
+            throw std::invalid_argument("El alfabeto es demasiado largo para la cabecera de la tabla.");
+        }
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        std::vector<Chain> chains(static_cast<size_t>(chainCount));
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; ++t) {
+            uint64_t begin = chainCount * t / threads;
+            uint64_t end = chainCount * (t + 1) / threads;
+            workers.emplace_back([&, begin, end]() {
+                for (uint64_t i = begin; i < end; ++i) {
+                    uint64_t start = mix(i) % space.size();
+                    chains[i].start = start;
+                    chains[i].end = walk(space, plaintext, start, 0, chainLength);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        parallelSort(chains.begin(), chains.end(),
+                     [](const Chain& a, const Chain& b) { return a.end < b.end; }, threads);
+        chains.erase(std::unique(chains.begin(), chains.end(),
+                                 [](const Chain& a, const Chain& b) { return a.end == b.end; }),
+                     chains.end());
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.plaintext = plaintext;
+        header.chainLength = chainLength;
+        header.chainCount = chains.size();
+        header.kind = static_cast<uint32_t>(space.kind);
+        header.knownBits = space.knownBits;
+        header.unknownMask = space.unknownMask;
+        header.passwordLength = static_cast<uint32_t>(space.passwordLength);
+        header.charsetLength = static_cast<uint32_t>(space.charset.size());
+        header.begin = space.begin;
+        header.end = space.end;
+        std::memcpy(header.charset, space.charset.data(), space.charset.size());
+
+        MappedFile file;
+        file.create(path, sizeof(Header) + chains.size() * sizeof(Chain));
+        std::memcpy(file.data(), &header, sizeof(Header));
+        std::memcpy(static_cast<char*>(file.data()) + sizeof(Header), chains.data(), chains.size() * sizeof(Chain));
+        file.flush();
+        return chains.size();
+    }
+
+    /**
+     * @brief Proyecta en memoria una tabla generada previamente.
+     * @param path Ruta del archivo de la tabla.
+     * @throws std::runtime_error Si el archivo no es una tabla válida.
+     */
+    void
+    open(const std::string& path) {
+        file_.openReadOnly(path);
+        if (file_.size() < sizeof(Header)) {
+            throw std::runtime_error("Archivo de tabla arcoíris truncado: " + path);
+        }
+        std::memcpy(&header_, file_.data(), sizeof(Header));
+        if (std::memcmp(header_.magic, MAGIC, sizeof(header_.magic)) != 0 ||
+            file_.size() < sizeof(Header) + header_.chainCount * sizeof(Chain)) {
+            throw std::runtime_error("Archivo de tabla arcoíris inválido: " + path);
+        }
+
+        space_ = DESKeySpace();
+        space_.kind = static_cast<DESKeySpace::Kind>(header_.kind);
+        space_.knownBits = header_.knownBits;
+        space_.unknownMask = header_.unknownMask;
+        space_.passwordLength = header_.passwordLength;
+        space_.charset.assign(header_.charset, header_.charsetLength);
+        space_.begin = header_.begin;
+        space_.end = header_.end;
+        chains_ = reinterpret_cast<const Chain*>(static_cast<const char*>(file_.data()) + sizeof(Header));
+    }
+
+    /**
+     * @brief Busca la clave que produjo 'ciphertext' al cifrar el texto plano de la tabla.
+     * Recorre las posiciones de la más cercana al final a la más lejana; cada coincidencia de final
+     * se confirma regenerando la cadena desde su inicio.
+     * @param ciphertext El cifrado del texto plano de la tabla.
+     * @return La clave encontrada (si la hay) y el número de cifrados realizados.
+     */
+    RainbowLookupResult
+    lookup(uint64_t ciphertext) const {
+        if (chains_ == nullptr) {
+            throw std::runtime_error("La tabla arcoíris no está abierta.");
+        }
+        auto start_time = std::chrono::steady_clock::now();
+        RainbowLookupResult result;
+        const uint64_t length = header_.chainLength;
+
+        for (uint64_t position = length; position-- > 0;) {
+            // Supone que el cifrado aparece en 'position' y avanza hasta el final de la cadena.
+            uint64_t index = reduce(ciphertext, position, space_.size());
+            uint64_t end = walk(space_, header_.plaintext, index, position + 1, length);
+            result.encryptions += length - position - 1;
+
+            const Chain* first = chains_;
+            const Chain* last = chains_ + header_.chainCount;
+            const Chain* hit = std::lower_bound(first, last, end,
+                                                [](const Chain& chain, uint64_t value) { return chain.end < value; });
+            if (hit == last || hit->end != end) {
+                continue;
+            }
+
+            // Regenera la cadena hasta 'position' para descartar falsas alarmas.
+            uint64_t candidate_index = walk(space_, header_.plaintext, hit->start, 0, position);
+            result.encryptions += position + 1;
+            uint64_t key = space_.keyAt(space_.begin + candidate_index);
+            if (DES::encodeWithSchedule(header_.plaintext, DES::fastSchedule(key)) == ciphertext) {
+                result.found = true;
+                result.key = key;
+                break;
+            }
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+    /**
+     * @brief Número de cadenas de la tabla abierta.
+     */
+    uint64_t
+    chainCount() const {
+        return header_.chainCount;
+    }
+
+    /**
+     * @brief Texto plano fijo de la tabla abierta.
+     */
+    uint64_t
+    plaintext() const {
+        return header_.plaintext;
+    }
+
+private:
+    static constexpr char MAGIC[8] = {'D', 'E', 'S', 'R', 'B', 'T', '0', '1'};
+
+    struct Header {
+        char magic[8];
+        uint64_t plaintext;
+        uint64_t chainLength;
+        uint64_t chainCount;
+        uint64_t knownBits;
+        uint64_t unknownMask;
+        uint64_t begin;
+        uint64_t end;
+        uint32_t kind;
+        uint32_t passwordLength;
+        uint32_t charsetLength;
+        uint32_t reserved;
+        char charset[256];
+    };
+
+    struct Chain {
+        uint64_t end;
+        uint64_t start;
+    };
+
+    static uint64_t
+    mix(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Función de reducción de la posición 'position': lleva un cifrado a un índice del espacio.
+     */
+    static uint64_t
+    reduce(uint64_t ciphertext, uint64_t position, uint64_t spaceSize) {
+        return mix(ciphertext ^ (position * 0xD6E8FEB86659FD93ULL)) % spaceSize;
+    }
+
+    /**
+     * @brief Avanza una cadena desde el índice 'index' en la posición 'from' hasta la posición 'to'.
+     * @return El índice de clave en la posición 'to'.
+     */
+    static uint64_t
+    walk(const DESKeySpace& space, uint64_t plaintext, uint64_t index, uint64_t from, uint64_t to) {
+        for (uint64_t position = from; position < to; ++position) {
+            uint64_t key = space.keyAt(space.begin + index);
+            uint64_t cipher = DES::encodeWithSchedule(plaintext, DES::fastSchedule(key));
+            index = reduce(cipher, position, space.size());
+        }
+        return index;
+    }
+
+    MappedFile file_;
+    Header header_{};
+    DESKeySpace space_;
+    const Chain* chains_ = nullptr;
+};
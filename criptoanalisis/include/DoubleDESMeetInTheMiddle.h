@@ -0,0 +1,220 @@
+#pragma once
+#include "DESKeySearch.h"
+#include "MappedFile.h"
+#include "ParallelSort.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Configuración del ataque de encuentro a medio camino.
+ */
+struct MeetInTheMiddleConfig {
+    // Memoria máxima para la tabla intermedia; si se supera, la tabla se escribe en 'spillPath'.
+    size_t memoryBudgetBytes = size_t(256) << 20;
+    std::string spillPath = "mitm_table.bin";
+    unsigned int threads = 0;
+};
+
+/**
+ * @brief Par de claves (K1, K2) que explica todos los pares conocidos: C = E_K2(E_K1(P)).
+ */
+struct DoubleDESKey {
+    uint64_t key1;
+    uint64_t key2;
+};
+
+/**
+ * @brief Resultado del ataque de encuentro a medio camino.
+ */
+struct MeetInTheMiddleResult {
+    std::vector<DoubleDESKey> keys;
+    uint64_t tableEntries = 0;
+    size_t sortedRuns = 0;
+    bool spilledToDisk = false;
+    uint64_t candidateMatches = 0;
+    double buildSeconds = 0.0;
+    double searchSeconds = 0.0;
+};
+
+/**
+ * @brief Ataque de encuentro a medio camino contra doble DES (C = E_K2(E_K1(P))).
+ * Fase 1: cifra P con cada K1 candidata y guarda (valor intermedio, índice de K1) en una tabla ordenada.
+ * Fase 2: descifra C con cada K2 candidata y busca el valor intermedio en la tabla.
+ * Si la tabla excede el presupuesto de memoria se construye en un archivo proyectado, se ordena por tramos
+ * del tamaño del presupuesto y los tramos se fusionan en una sola tabla ordenada en 'spillPath'
+ * (mientras dura la fusión hace falta el doble de espacio en disco). Cada búsqueda es un único lower_bound.
+ */
+class DoubleDESMeetInTheMiddle {
+public:
+    DoubleDESMeetInTheMiddle(const MeetInTheMiddleConfig& config = MeetInTheMiddleConfig()) :
+        config_(config),
+        threads_(config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+
+    ~DoubleDESMeetInTheMiddle() = default;
+
+    /**
+     * @brief Ejecuta el ataque.
+     * @param pairs Pares conocidos; el primero se usa para el encuentro y el resto para verificar.
+     * @param firstKeys Espacio de claves candidatas para K1 (como máximo 2^32 claves).
+     * @param secondKeys Espacio de claves candidatas para K2.
+     * @return Las parejas de claves verificadas y estadísticas del ataque.
+     */
+    MeetInTheMiddleResult
+    attack(const std::vector<DESKnownPair>& pairs, const DESKeySpace& firstKeys, const DESKeySpace& secondKeys) {
+        if (pairs.empty()) {
+            throw std::invalid_argument("Se necesita al menos un par texto plano/cifrado.");
+        }
+        if (firstKeys.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("El espacio de K1 no puede superar 2^32 claves.");
+        }
+
+        MeetInTheMiddleResult result;
+        auto start_time = std::chrono::steady_clock::now();
+
+        uint64_t entries = firstKeys.size();
+        result.tableEntries = entries;
+        Entry* table = allocateTable(entries, result);
+
+        // Fase 1: valores intermedios E_K1(P), en paralelo por tramos de índices.
+        const uint64_t plaintext = pairs[0].plaintext;
+        runParallel(entries, [&](uint64_t begin, uint64_t end) {
+            DESKeySpace::Cursor cursor(firstKeys, firstKeys.begin + begin);
+            for (uint64_t i = begin; i < end; ++i, cursor.advance()) {
+                table[i].middle = DES::encodeWithSchedule(plaintext, DES::fastSchedule(cursor.key()));
+                table[i].keyIndex = static_cast<uint32_t>(i);
+            }
+        });
+
+        uint64_t run_entries = std::max<uint64_t>(1, config_.memoryBudgetBytes / sizeof(Entry));
+        std::vector<size_t> run_bounds;
+        for (uint64_t run_begin = 0; run_begin < entries; run_begin += run_entries) {
+            uint64_t run_end = std::min(entries, run_begin + run_entries);
+            parallelSort(table + run_begin, table + run_end, compareEntries, threads_);
+            run_bounds.push_back(static_cast<size_t>(run_begin));
+        }
+        run_bounds.push_back(static_cast<size_t>(entries));
+        result.sortedRuns = run_bounds.size() - 1;
+        if (result.sortedRuns > 1) {
+            table = mergeRuns(table, run_bounds);
+        }
+        result.buildSeconds = secondsSince(start_time);
+
+        // Fase 2: D_K2(C) contra la tabla y verificación con el resto de pares.
+        start_time = std::chrono::steady_clock::now();
+        const uint64_t ciphertext = pairs[0].ciphertext;
+        std::mutex result_mutex;
+        std::atomic<uint64_t> matches{0};
+
+        runParallel(secondKeys.size(), [&](uint64_t begin, uint64_t end) {
+            DESKeySpace::Cursor cursor(secondKeys, secondKeys.begin + begin);
+            uint64_t local_matches = 0;
+            for (uint64_t i = begin; i < end; ++i, cursor.advance()) {
+                DES::FastSchedule schedule2 = DES::fastSchedule(cursor.key());
+                uint64_t middle = DES::decodeWithSchedule(ciphertext, schedule2);
+
+                Entry probe{middle, 0};
+                Entry* hit = std::lower_bound(table, table + entries, probe, compareEntries);
+                for (; hit != table + entries && hit->middle == middle; ++hit) {
+                    ++local_matches;
+                    uint64_t key1 = firstKeys.keyAt(firstKeys.begin + hit->keyIndex);
+                    if (verify(pairs, DES::fastSchedule(key1), schedule2)) {
+                        std::lock_guard<std::mutex> lock(result_mutex);
+                        result.keys.push_back({key1, cursor.key()});
+                    }
+                }
+            }
+            matches.fetch_add(local_matches);
+        });
+
+        result.candidateMatches = matches.load();
+        result.searchSeconds = secondsSince(start_time);
+
+        memory_table_.clear();
+        memory_table_.shrink_to_fit();
+        spill_file_.close();
+        return result;
+    }
+
+private:
+#pragma pack(push, 1)
+    struct Entry {
+        uint64_t middle;
+        uint32_t keyIndex;
+    };
+#pragma pack(pop)
+
+    static bool
+    compareEntries(const Entry& a, const Entry& b) {
+        return a.middle < b.middle;
+    }
+
+    Entry*
+    allocateTable(uint64_t entries, MeetInTheMiddleResult& result) {
+        size_t bytes = static_cast<size_t>(entries * sizeof(Entry));
+        if (bytes <= config_.memoryBudgetBytes) {
+            memory_table_.resize(static_cast<size_t>(entries));
+            return memory_table_.data();
+        }
+        run_file_.create(runsPath(), bytes);
+        result.spilledToDisk = true;
+        return static_cast<Entry*>(run_file_.data());
+    }
+
+    std::string
+    runsPath() const {
+        return config_.spillPath + ".tramos";
+    }
+
+    /**
+     * @brief Fusiona los tramos ordenados del archivo temporal en 'spillPath' y borra el temporal.
+     * @return La tabla ordenada completa.
+     */
+    Entry*
+    mergeRuns(const Entry* runs, const std::vector<size_t>& run_bounds) {
+        spill_file_.create(config_.spillPath, run_file_.size());
+        Entry* table = static_cast<Entry*>(spill_file_.data());
+        mergeSortedRuns(runs, run_bounds, table, compareEntries);
+        run_file_.close();
+        std::remove(runsPath().c_str());
+        return table;
+    }
+
+    template <typename Work>
+    void
+    runParallel(uint64_t count, Work work) {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads_; ++t) {
+            uint64_t begin = count * t / threads_;
+            uint64_t end = count * (t + 1) / threads_;
+            if (begin < end) {
+                workers.emplace_back(work, begin, end);
+            }
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static bool
+    verify(const std::vector<DESKnownPair>& pairs, const DES::FastSchedule& schedule1,
+           const DES::FastSchedule& schedule2) {
+        for (const auto& pair : pairs) {
+            uint64_t middle = DES::encodeWithSchedule(pair.plaintext, schedule1);
+            if (DES::encodeWithSchedule(middle, schedule2) != pair.ciphertext) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static double
+    secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    MeetInTheMiddleConfig config_;
+    unsigned int threads_;
+    std::vector<Entry> memory_table_;
+    MappedFile run_file_;
+    MappedFile spill_file_;
+};
@@ -1,5 +1,7 @@
 ﻿#pragma once
+#include "BalancedRequestPool.h"
 #include "Prerequisites.h"
+#include "ScoreCache.h"
 
 struct EvaluationResult {
     std::string text;
@@ -11,24 +13,77 @@ struct EvaluationResult {
     }
 };
 
+/**
+ * @brief Puntuación de la API para un candidato, identificado por su posición en la lista evaluada.
+ */
+struct ScoredCandidate {
+    size_t index;
+    double congruence_score;
+
+    bool operator<(const ScoredCandidate& other) const {
+        return congruence_score > other.congruence_score
+            || (congruence_score == other.congruence_score && index < other.index);
+    }
+};
+
+/**
+ * @brief Formato de los cuerpos de petición y respuesta de la API de congruencia.
+ */
+enum class WireFormat {
+    Json,
+    Cbor,
+    MessagePack
+};
+
 class EvaluationIA {
 public:
+    using Clock = std::chrono::steady_clock;
+    using ResultCallback = std::function<void(const ScoredCandidate&)>;
+
+    // Puntuación máxima que devuelve el servidor de congruencia.
+    static constexpr double MAX_SCORE = 10.0;
+    // Tiempo máximo por operación (todas sus peticiones juntas), salvo que se cambie con set_deadline.
+    static constexpr std::chrono::milliseconds DEFAULT_DEADLINE{15000};
+    // Textos por petición al endpoint por lotes cuando se entregan resultados según llegan:
+    // trozos pequeños entregan antes las primeras puntuaciones.
+    static constexpr size_t STREAM_CHUNK = 8;
+    // Tamaño de trozo que envía la lista completa en una petición por servidor activo.
+    static constexpr size_t WHOLE_LIST = 0;
+
+    /**
+     * @param base_api_url URL base del servidor de congruencia.
+     * @param api_path Ruta del endpoint que evalúa un texto.
+     * @param batch_api_path Ruta del endpoint que evalúa una lista de textos.
+     * @param max_in_flight Conexiones keep-alive (y peticiones simultáneas) hacia el servidor.
+     * Los evaluadores del mismo servidor comparten un cortacircuitos: tras varios fallos seguidos
+     * la API se omite al instante hasta que un sondeo vuelva a responder.
+     * Las peticiones empiezan en JSON y pasan a CBOR cuando el servidor anuncia que lo admite
+     * (cabecera Accept-Post); si aun así lo rechaza, se repiten en JSON y ese evaluador sigue en JSON.
+     */
     EvaluationIA(const std::string& base_api_url = "http://localhost:8000",
-                        const std::string& api_path = "/evaluar_congruencia/") :
-        base_api_url_(base_api_url), api_path_(api_path) {
-        try {
-            cli_ = std::make_unique<httplib::Client>(base_api_url_);
-            if (!cli_) {
-                throw std::runtime_error("Fallo crítico: creación instancia httplib::Client.");
-            }
-            cli_->set_connection_timeout(5, 0);
-            cli_->set_read_timeout(10, 0);
-            cli_->set_write_timeout(10, 0);
+                        const std::string& api_path = "/evaluar_congruencia/",
+                        const std::string& batch_api_path = "/evaluar_congruencia_lote/",
+                        size_t max_in_flight = 4) :
+        EvaluationIA(std::vector<std::string>{base_api_url}, api_path, batch_api_path, max_in_flight) {
+    }
 
-            if (!cli_->is_valid()) {
-                throw std::runtime_error(
-                    "Error: URL API '" + base_api_url_ + "' inválida o fallo inicialización cliente HTTP.");
-            }
+    /**
+     * @brief Evaluador repartido entre varios servidores equivalentes (el mismo modelo en puertos distintos).
+     * Cada petición va al servidor disponible con menos peticiones pendientes, los lotes se dividen
+     * entre los servidores y los que fallan la comprobación de salud o son mucho más lentos que el resto
+     * dejan de recibir peticiones temporalmente.
+     * @param base_api_urls URLs base de los servidores; la primera identifica al modelo en la caché.
+     * @param max_in_flight Conexiones keep-alive (y peticiones simultáneas) hacia cada servidor.
+     */
+    EvaluationIA(const std::vector<std::string>& base_api_urls,
+                 const std::string& api_path = "/evaluar_congruencia/",
+                 const std::string& batch_api_path = "/evaluar_congruencia_lote/",
+                 size_t max_in_flight = 4) :
+        base_api_url_(base_api_urls.empty() ? std::string() : base_api_urls.front()), api_path_(api_path),
+        batch_api_path_(batch_api_path), model_id_(base_api_url_), cache_(&ScoreCache::shared()),
+        deadline_(DEFAULT_DEADLINE) {
+        try {
+            pool_ = std::make_unique<BalancedRequestPool>(base_api_urls, max_in_flight);
         } catch (const std::exception& e) {
             std::cerr << "Error al inicializar CongruenceEvaluator: " << e.what() << std::endl;
             throw;
@@ -44,7 +99,7 @@ public:
     void
     evaluate_and_print_top_three(const std::vector<std::string>& texts,
                                       const std::vector<std::string>& identifiers) {
-        if (!cli_ || !cli_->is_valid()) {
+        if (!pool_) {
             std::cerr << "Error: Cliente HTTP no inicializado/configurado." << std::endl;
             return;
         }
@@ -53,71 +108,119 @@ public:
             return;
         }
 
-        std::vector<EvaluationResult> all_results;
-        nlohmann::json request_json_payload;
+        std::vector<EvaluationResult> top_three;
+        for (const ScoredCandidate& candidate : rank(texts, identifiers, 3, WHOLE_LIST, nullptr,
+                                                               Clock::time_point())) {
+            top_three.push_back({texts[candidate.index], candidate.congruence_score, identifiers[candidate.index]});
+        }
+        print_top_three(top_three, texts.size());
+    }
 
-        for (size_t i = 0; i < texts.size(); ++i) {
-            const auto& text_to_evaluate = texts[i];
-            const auto& identifier_for_text = identifiers[i];
-
-            request_json_payload["texto"] = text_to_evaluate;
-            std::string request_body_str = request_json_payload.dump();
-
-            auto res = cli_->Post(api_path_.c_str(), request_body_str, "application/json");
-
-            if (res) {
-                if (res->status == 200) {
-                    try {
-                        nlohmann::json response_json = nlohmann::json::parse(res->body);
-                        if (response_json.contains("puntuacion_congruencia")) {
-                            double score = response_json["puntuacion_congruencia"].get<double>();
-                            all_results.push_back({text_to_evaluate, score, identifier_for_text});
-                            // Incluye el identificador
-                        } else {
-                            std::cerr << "Warn: 'puntuacion_congruencia' no hallada para \"" << text_to_evaluate <<
-                                "\". ID: " << identifier_for_text << ". Resp: " << (res->body.size() > 80
-                                    ? res->body.substr(0, 80) + "..."
-                                    : res->body) << std::endl;
-                        }
-                    } catch (const nlohmann::json::parse_error& e) {
-                        std::cerr << "Error JSON parse (" << text_to_evaluate << ", ID: " << identifier_for_text <<
-                            "): " << e.what() << ". Body: " << (res->body.size() > 80
-                                ? res->body.substr(0, 80) + "..."
-                                : res->body) << std::endl;
-                    } catch (const nlohmann::json::type_error& e) {
-                        std::cerr << "Error JSON type (" << text_to_evaluate << ", ID: " << identifier_for_text << "): "
-                            << e.what() << ". Body: " << (res->body.size() > 80
-                                ? res->body.substr(0, 80) + "..."
-                                : res->body) << std::endl;
-                    }
-                } else {
-                    std::cerr << "Error API (" << text_to_evaluate << ", ID: " << identifier_for_text << "): status " <<
-                        res->status << ". Resp: " << (res->body.size() > 80
-                            ? res->body.substr(0, 80) + "..."
-                            : res->body) << std::endl;
+    /**
+     * @brief Evalúa los textos y devuelve los 'top_k' mejores, de mejor a peor.
+     * Las puntuaciones se entregan a 'on_result' según llegan (primero las de la caché), de una en una,
+     * para que el llamador pueda actuar sobre un buen candidato antes de que termine la operación.
+     * Con 'on_result' los textos van en trozos de STREAM_CHUNK al endpoint por lotes; sin él, en una sola
+     * petición por servidor activo. Si el endpoint por lotes no existe, van uno a uno.
+     * Solo se conservan los 'top_k' mejores, en un montículo acotado y sin copiar los textos.
+     * @param texts Los textos candidatos.
+     * @param top_k Número máximo de resultados devueltos.
+     * @param on_result Opcional; recibe cada puntuación obtenida, desde un hilo del grupo o desde este.
+     * @param deadline Plazo de la operación; por defecto, ahora más el configurado con set_deadline.
+     * @return Los mejores resultados, referidos por su índice en 'texts'.
+     */
+    std::vector<ScoredCandidate>
+    evaluate(const std::vector<std::string>& texts, size_t top_k = 3, ResultCallback on_result = nullptr,
+             Clock::time_point deadline = {}) {
+        const size_t chunk_size = on_result ? STREAM_CHUNK : WHOLE_LIST;
+        return rank(texts, {}, top_k, chunk_size, std::move(on_result), deadline);
+    }
+
+    /**
+     * @brief Como evaluate(), pero sin bloquear: 'on_finished' recibe los mejores resultados cuando se han
+     * resuelto todos los textos, desde un hilo del grupo (o desde este si no hizo falta ninguna petición).
+     * No debe esperar a otra petición del evaluador. 'texts' debe seguir vivo hasta entonces.
+     */
+    void
+    evaluate_async(const std::vector<std::string>& texts, size_t top_k, ResultCallback on_result,
+                   std::function<void(std::vector<ScoredCandidate>)> on_finished, Clock::time_point deadline = {}) {
+        static const std::vector<std::string> no_identifiers;
+        const size_t chunk_size = on_result ? STREAM_CHUNK : WHOLE_LIST;
+        rank(texts, no_identifiers, top_k, chunk_size, std::move(on_result), std::move(on_finished), deadline);
+    }
+
+    /**
+     * @brief Evaluación en cascada: los textos se ordenan por su puntuación local y solo los 'top_k'
+     * mejores se envían a la API, de uno en uno y en ese orden. La cascada se detiene en cuanto un
+     * texto alcanza 'stop_score' (por defecto la puntuación máxima), así que en el caso habitual
+     * basta una sola petición. Todas las peticiones comparten el plazo de la operación.
+     * @param texts Los textos candidatos.
+     * @param identifiers Identificadores de cada texto (mismo tamaño y orden que 'texts').
+     * @param local_scores Puntuación local de cada texto; mayor es mejor.
+     * @param top_k Número máximo de textos que se envían a la API.
+     * @param stop_score Puntuación de la API a partir de la cual se deja de evaluar.
+     * @return Los resultados obtenidos de la API, de mejor a peor.
+     */
+    std::vector<EvaluationResult>
+    evaluate_cascade(const std::vector<std::string>& texts, const std::vector<std::string>& identifiers,
+                     const std::vector<double>& local_scores, size_t top_k = 4,
+                     double stop_score = MAX_SCORE) {
+        std::vector<EvaluationResult> results;
+        if (!pool_) {
+            std::cerr << "Error: Cliente HTTP no inicializado/configurado." << std::endl;
+            return results;
+        }
+        if (texts.size() != identifiers.size() || texts.size() != local_scores.size()) {
+            std::cerr << "Error: El número de textos, identificadores y puntuaciones locales no coincide."
+                << std::endl;
+            return results;
+        }
+        const Clock::time_point deadline = Clock::now() + deadline_;
+        if (!api_available()) {
+            return results;
+        }
+        std::vector<size_t> order(texts.size());
+        std::iota(order.begin(), order.end(), 0);
+        top_k = std::min(top_k, order.size());
+        std::partial_sort(order.begin(), order.begin() + top_k, order.end(),
+                          [&](size_t a, size_t b) { return local_scores[a] > local_scores[b]; });
+
+        size_t sent = 0;
+        for (size_t i = 0; i < top_k && Clock::now() < deadline && pool_->available(); ++i) {
+            const size_t index = order[i];
+            ++sent;
+            std::optional<double> score = score_async(texts[index], identifiers[index], deadline).get();
+            if (score) {
+                results.push_back({texts[index], *score, identifiers[index]});
+                if (*score >= stop_score) {
+                    break;
                 }
-            } else {
-                auto err_code = res.error();
-                std::cerr << "Error HTTP lib (" << text_to_evaluate << ", ID: " << identifier_for_text << "): " <<
-                    httplib::to_string(err_code) << (
-                        err_code == httplib::Error::Connection && base_api_url_.rfind("http://localhost", 0) == 0
-                        ? " (Verifique servidor en " + base_api_url_ + ")"
-                        : "") << std::endl;
             }
         }
+        std::cout << "Cascada: " << sent << " de " << texts.size() << " candidatos evaluados por la API."
+            << std::endl;
+        report_deadline(deadline);
+        std::sort(results.begin(), results.end());
+        return results;
+    }
 
-        std::sort(all_results.begin(), all_results.end());
-
+    /**
+     * @brief Muestra los 3 mejores resultados de la API.
+     * @param results Resultados ordenados de mejor a peor.
+     * @param candidates Número de textos que se quisieron evaluar.
+     */
+    void
+    print_top_three(const std::vector<EvaluationResult>& results, size_t candidates) const {
         std::cout << "\nTop 3 Puntuaciones de Congruencia (API):" << std::endl;
         std::cout << std::fixed << std::setprecision(2);
 
-        if (texts.empty()) {
+        if (candidates == 0) {
             std::cout << "  No se proporcionaron textos." << std::endl;
-        } else if (all_results.empty()) {
+        } else if (results.empty()) {
             std::cout << "  No se obtuvieron resultados válidos de la API." << std::endl;
         } else {
             int count = 0;
-            for (const auto& result : all_results) {
+            for (const auto& result : results) {
                 if (count < 3) {
                     std::cout << "  " << count + 1 << ". ID/Recorrido: [" << result.identifier
                         << "], Puntuación: " << result.congruence_score
@@ -129,15 +232,588 @@ public:
                     break;
                 }
             }
-            if (count > 0 && count < 3 && count == all_results.size()) {
+            if (count > 0 && count < 3 && count == results.size()) {
                 std::cout << "  (Se mostraron todos los " << count <<
                     " resultados disponibles ya que fueron menos de 3)" << std::endl;
             }
         }
     }
 
+    /**
+     * @brief Evalúa todos los textos con una sola petición al endpoint por lotes (una por servidor activo).
+     * Solo se envían los textos que no están en la caché; si están todos, no hay petición.
+     * Si el endpoint por lotes no está disponible, los textos se evalúan uno a uno.
+     * @param texts Los textos a evaluar.
+     * @param deadline Plazo de la operación; por defecto, ahora más el configurado con set_deadline.
+     * @return La puntuación de cada texto (vacía si la API no la devolvió), en el mismo orden.
+     */
+    std::vector<std::optional<double>>
+    evaluate_batch(const std::vector<std::string>& texts, Clock::time_point deadline = {}) {
+        std::vector<std::optional<double>> scores(texts.size());
+        for (const ScoredCandidate& candidate : rank(texts, {}, texts.size(), WHOLE_LIST, nullptr, deadline)) {
+            scores[candidate.index] = candidate.congruence_score;
+        }
+        return scores;
+    }
+
+    /**
+     * @brief Evalúa un texto con el endpoint individual sin bloquear.
+     * @param text El texto a evaluar.
+     * @param callback Se llama desde un hilo del grupo con la puntuación (vacía si hubo un error),
+     * o directamente desde este hilo si la puntuación ya estaba en la caché.
+     * @param identifier Identificador usado en los mensajes de error.
+     * @param deadline Plazo de la petición; por defecto, ahora más el configurado con set_deadline.
+     */
+    void
+    score_async(const std::string& text, std::function<void(std::optional<double>)> callback,
+                const std::string& identifier = "", Clock::time_point deadline = {}) {
+        if (std::optional<double> cached = cached_score(text)) {
+            callback(cached);
+            return;
+        }
+        send_single(text, identifier, resolve_deadline(deadline), std::move(callback));
+    }
+
+    /**
+     * @brief Evalúa un texto con el endpoint individual y devuelve un futuro con su puntuación.
+     */
+    std::future<std::optional<double>>
+    score_async(const std::string& text, const std::string& identifier = "", Clock::time_point deadline = {}) {
+        auto promise = std::make_shared<std::promise<std::optional<double>>>();
+        std::future<std::optional<double>> future = promise->get_future();
+        score_async(text, [promise](std::optional<double> score) { promise->set_value(score); }, identifier,
+                    deadline);
+        return future;
+    }
+
+    /**
+     * @brief Evalúa todos los textos con peticiones simultáneas (hasta max_in_flight a la vez).
+     * El resultado i corresponde siempre a texts[i], sin importar el orden en que terminen.
+     * Todas las peticiones comparten el mismo plazo.
+     */
+    std::vector<std::optional<double>>
+    score_all(const std::vector<std::string>& texts, const std::vector<std::string>& identifiers = {},
+              Clock::time_point deadline = {}) {
+        deadline = resolve_deadline(deadline);
+        std::vector<std::future<std::optional<double>>> futures;
+        futures.reserve(texts.size());
+        for (size_t i = 0; i < texts.size(); ++i) {
+            futures.push_back(score_async(texts[i], i < identifiers.size() ? identifiers[i] : std::to_string(i),
+                                          deadline));
+        }
+        std::vector<std::optional<double>> scores;
+        scores.reserve(texts.size());
+        for (auto& future : futures) {
+            scores.push_back(future.get());
+        }
+        return scores;
+    }
+
+    /**
+     * @brief Cambia la caché de puntuaciones (nullptr la desactiva). No pasa a ser propiedad del evaluador.
+     */
+    void
+    set_cache(ScoreCache* cache) {
+        cache_ = cache;
+    }
+
+    /**
+     * @brief Identificador del modelo que forma parte de la clave de la caché.
+     * Por defecto es la URL base del servidor; conviene cambiarlo si el servidor cambia de modelo.
+     */
+    void
+    set_model_id(const std::string& model_id) {
+        model_id_ = model_id;
+    }
+
+    const std::string&
+    model_id() const {
+        return model_id_;
+    }
+
+    /**
+     * @brief Tiempo máximo de cada operación; todas sus peticiones descuentan de él.
+     */
+    void
+    set_deadline(std::chrono::milliseconds deadline) {
+        deadline_ = deadline;
+    }
+
+    /**
+     * @brief Formato preferido para las peticiones (la respuesta se pide en el mismo formato).
+     * Un formato binario solo se usa cuando el servidor lo anuncia; hasta entonces se envía JSON.
+     */
+    void
+    set_wire_format(WireFormat format) {
+        preferred_format_ = format;
+        if (format == WireFormat::Json) {
+            wire_format_ = WireFormat::Json;
+        }
+    }
+
+    WireFormat
+    wire_format() const {
+        return wire_format_;
+    }
+
+    /**
+     * @brief Activa la cobertura de las peticiones individuales: si una tarda más que el percentil 95
+     * observado, se duplica en otro servidor y se usa la primera respuesta. Desactivada por defecto.
+     */
+    void
+    set_hedging(bool enabled) {
+        hedging_ = enabled;
+    }
+
+    /**
+     * @brief Copias de cobertura enviadas y peticiones totales, para vigilar el coste de la cobertura.
+     */
+    std::pair<uint64_t, uint64_t>
+    hedging_stats() const {
+        return {pool_->hedgesSent(), pool_->requestsSent()};
+    }
+
+    /**
+     * @brief Estado de cada servidor (pendientes, latencia media, salud, expulsión y cortacircuitos).
+     */
+    std::vector<BackendStatus>
+    backends() const {
+        return pool_->status();
+    }
+
 private:
+    /**
+     * @brief Estado compartido de una evaluación: los mejores resultados hasta ahora (montículo cuya
+     * cima es el peor de ellos) y cuántas entregas faltan. Mientras se envían las peticiones hay una
+     * entrega reservada, así que 'on_finished' nunca se llama antes de que termine el envío.
+     */
+    struct Ranking {
+        std::mutex mutex;
+        size_t pending = 0;
+        size_t top_k = 0;
+        ResultCallback on_result;
+        std::function<void(std::vector<ScoredCandidate>)> on_finished;
+        std::vector<ScoredCandidate> best;
+
+        /**
+         * @brief Registra el resultado de un texto (vacío si no se obtuvo).
+         */
+        void
+        deliver(size_t index, std::optional<double> score) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (score) {
+                    ScoredCandidate candidate{index, *score};
+                    best.push_back(candidate);
+                    std::push_heap(best.begin(), best.end());
+                    if (best.size() > top_k) {
+                        std::pop_heap(best.begin(), best.end());
+                        best.pop_back();
+                    }
+                    if (on_result) {
+                        on_result(candidate);
+                    }
+                }
+            }
+            release();
+        }
+
+        /**
+         * @brief Descuenta una entrega; con la última, ordena los resultados y llama a 'on_finished'.
+         */
+        void
+        release() {
+            std::vector<ScoredCandidate> result;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending != 0) {
+                    return;
+                }
+                result = std::move(best);
+            }
+            std::sort_heap(result.begin(), result.end());
+            on_finished(std::move(result));
+        }
+    };
+
+    /**
+     * @brief Implementación de evaluate() y evaluate_async(); 'identifiers' (opcional) se usa en los
+     * mensajes de error. 'texts' e 'identifiers' deben seguir vivos hasta que se llame a 'on_finished'.
+     * @param chunk_size Textos por petición al endpoint por lotes; WHOLE_LIST reparte la lista completa
+     * en una petición por servidor activo.
+     */
+    void
+    rank(const std::vector<std::string>& texts, const std::vector<std::string>& identifiers, size_t top_k,
+         size_t chunk_size, ResultCallback on_result, std::function<void(std::vector<ScoredCandidate>)> on_finished,
+         Clock::time_point deadline) {
+        if (!pool_) {
+            std::cerr << "Error: Cliente HTTP no inicializado/configurado." << std::endl;
+            on_finished({});
+            return;
+        }
+        deadline = resolve_deadline(deadline);
+        auto remote = std::make_shared<std::atomic<bool>>(false);
+        auto ranking = std::make_shared<Ranking>();
+        ranking->pending = texts.size() + 1;
+        ranking->top_k = top_k;
+        ranking->on_result = std::move(on_result);
+        ranking->on_finished = [this, deadline, remote, on_finished = std::move(on_finished)](
+            std::vector<ScoredCandidate> best) {
+            if (*remote) {
+                report_deadline(deadline);
+            }
+            on_finished(std::move(best));
+        };
+
+        std::vector<size_t> misses;
+        for (size_t i = 0; i < texts.size(); ++i) {
+            if (std::optional<double> cached = cached_score(texts[i])) {
+                ranking->deliver(i, cached);
+            } else {
+                misses.push_back(i);
+            }
+        }
+        if (!misses.empty()) {
+            if (!api_available()) {
+                for (size_t index : misses) {
+                    ranking->deliver(index, std::nullopt);
+                }
+            } else {
+                *remote = true;
+                if (batch_supported_) {
+                    if (chunk_size == WHOLE_LIST) {
+                        const size_t parts = std::max<size_t>(1, pool_->activeCount());
+                        chunk_size = (misses.size() + parts - 1) / parts;
+                    }
+                    for (size_t begin = 0; begin < misses.size(); begin += chunk_size) {
+                        std::vector<size_t> chunk(misses.begin() + begin,
+                                                  misses.begin() + std::min(begin + chunk_size, misses.size()));
+                        stream_batch(texts, identifiers, std::move(chunk), deadline, wire_format_, ranking);
+                    }
+                } else {
+                    for (size_t index : misses) {
+                        stream_single(texts, identifiers, index, deadline, ranking);
+                    }
+                }
+            }
+        }
+        ranking->release();
+    }
+
+    /**
+     * @brief Versión bloqueante de rank().
+     */
+    std::vector<ScoredCandidate>
+    rank(const std::vector<std::string>& texts, const std::vector<std::string>& identifiers, size_t top_k,
+         size_t chunk_size, ResultCallback on_result, Clock::time_point deadline) {
+        auto promise = std::make_shared<std::promise<std::vector<ScoredCandidate>>>();
+        std::future<std::vector<ScoredCandidate>> future = promise->get_future();
+        rank(texts, identifiers, top_k, chunk_size, std::move(on_result),
+             [promise](std::vector<ScoredCandidate> best) { promise->set_value(std::move(best)); }, deadline);
+        return future.get();
+    }
+
+    /**
+     * @brief Envía un trozo de textos al endpoint por lotes y entrega sus puntuaciones al llegar.
+     * Si el endpoint no está disponible o la respuesta no es válida, el trozo se evalúa texto por texto.
+     */
+    void
+    stream_batch(const std::vector<std::string>& texts, const std::vector<std::string>& identifiers,
+                 std::vector<size_t> chunk, Clock::time_point deadline, WireFormat format,
+                 const std::shared_ptr<Ranking>& ranking) {
+        nlohmann::json payload;
+        payload["textos"] = nlohmann::json::array();
+        for (size_t index : chunk) {
+            payload["textos"].push_back(texts[index]);
+        }
+        pool_->submit(batch_api_path_, encode_body(payload, format), media_type(format),
+                      [this, &texts, &identifiers, chunk = std::move(chunk), deadline, format, ranking](
+                      HttpReply reply) {
+                          adopt_advertised_format(reply);
+                          if (format_rejected(reply, format)) {
+                              stream_batch(texts, identifiers, chunk, deadline, WireFormat::Json, ranking);
+                              return;
+                          }
+                          std::vector<std::optional<double>> scores(chunk.size());
+                          if (read_batch_reply(reply, texts, chunk, scores)) {
+                              for (size_t j = 0; j < chunk.size(); ++j) {
+                                  ranking->deliver(chunk[j], scores[j]);
+                              }
+                          } else {
+                              for (size_t index : chunk) {
+                                  stream_single(texts, identifiers, index, deadline, ranking);
+                              }
+                          }
+                      }, deadline, media_type(format));
+    }
+
+    void
+    stream_single(const std::vector<std::string>& texts, const std::vector<std::string>& identifiers,
+                  size_t index, Clock::time_point deadline, const std::shared_ptr<Ranking>& ranking) {
+        score_async(texts[index], [ranking, index](std::optional<double> score) { ranking->deliver(index, score); },
+                    index < identifiers.size() ? identifiers[index] : std::to_string(index), deadline);
+    }
+
+    /**
+     * @brief Copia en 'scores' (una por texto del trozo, en su orden) las puntuaciones de la respuesta
+     * a un trozo del lote.
+     * @return false si el endpoint por lotes no está disponible o la respuesta no es válida
+     * (el llamador recurre entonces al endpoint individual).
+     */
+    bool
+    read_batch_reply(const HttpReply& res, const std::vector<std::string>& texts, const std::vector<size_t>& chunk,
+                     std::vector<std::optional<double>>& scores) {
+        if (res.skipped || res.expired) {
+            return true;
+        }
+        if (res.error != httplib::Error::Success) {
+            // Sin conexión, repetir texto por texto solo multiplicaría la espera.
+            std::cerr << "Error HTTP lib (lote de " << chunk.size() << " textos): " << httplib::to_string(res.error)
+                << std::endl;
+            return true;
+        }
+        if (res.status == 404 || res.status == 405) {
+            // Servidor antiguo sin endpoint por lotes: se usa el individual a partir de ahora.
+            if (batch_supported_.exchange(false)) {
+                std::cerr << "Aviso: endpoint por lotes no disponible en " << base_api_url_
+                    << "; se evaluará texto por texto." << std::endl;
+            }
+            return false;
+        }
+        if (res.status != 200) {
+            std::cerr << "Error API (lote de " << chunk.size() << " textos): status " << res.status << std::endl;
+            return false;
+        }
+        try {
+            nlohmann::json response_json = decode_body(res);
+            const auto& resultados = response_json.at("resultados");
+            if (!resultados.is_array() || resultados.size() != chunk.size()) {
+                std::cerr << "Error API (lote): número de resultados inesperado." << std::endl;
+                return false;
+            }
+            for (size_t j = 0; j < chunk.size(); ++j) {
+                if (resultados[j].contains("puntuacion_congruencia")) {
+                    double score = resultados[j]["puntuacion_congruencia"].get<double>();
+                    scores[j] = score;
+                    store_score(texts[chunk[j]], score);
+                }
+            }
+            return true;
+        } catch (const nlohmann::json::exception& e) {
+            std::cerr << "Error JSON (lote): " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    static const char*
+    media_type(WireFormat format) {
+        switch (format) {
+        case WireFormat::Cbor:
+            return "application/cbor";
+        case WireFormat::MessagePack:
+            return "application/msgpack";
+        case WireFormat::Json:
+        default:
+            return "application/json";
+        }
+    }
+
+    static std::string
+    encode_body(const nlohmann::json& payload, WireFormat format) {
+        if (format == WireFormat::Json) {
+            return payload.dump();
+        }
+        std::vector<std::uint8_t> bytes =
+            format == WireFormat::Cbor ? nlohmann::json::to_cbor(payload) : nlohmann::json::to_msgpack(payload);
+        return std::string(bytes.begin(), bytes.end());
+    }
+
+    /**
+     * @brief Decodifica la respuesta según su Content-Type (JSON si no es CBOR ni MessagePack).
+     * @throws nlohmann::json::parse_error Si el cuerpo no es válido.
+     */
+    static nlohmann::json
+    decode_body(const HttpReply& reply) {
+        if (reply.contentType.rfind("application/cbor", 0) == 0) {
+            return nlohmann::json::from_cbor(reply.body);
+        }
+        if (reply.contentType.rfind("application/msgpack", 0) == 0 ||
+            reply.contentType.rfind("application/x-msgpack", 0) == 0) {
+            return nlohmann::json::from_msgpack(reply.body);
+        }
+        return nlohmann::json::parse(reply.body);
+    }
+
+    /**
+     * @brief Pasa al formato preferido si la respuesta lo anuncia en Accept-Post. Los servidores que
+     * solo entienden JSON no envían esa cabecera, así que con ellos el evaluador no sale de JSON.
+     */
+    void
+    adopt_advertised_format(const HttpReply& reply) {
+        const WireFormat preferred = preferred_format_;
+        if (preferred == WireFormat::Json || reply.error != httplib::Error::Success
+            || reply.acceptPost.find(media_type(preferred)) == std::string::npos) {
+            return;
+        }
+        WireFormat expected = WireFormat::Json;
+        wire_format_.compare_exchange_strong(expected, preferred);
+    }
+
+    /**
+     * @brief true si el servidor rechazó el formato binario; en ese caso el evaluador pasa a JSON.
+     * Un 415 siempre es un rechazo. Un 422 o un 5xx solo lo son si la respuesta no viene en el formato
+     * enviado: el servidor actual devuelve sus errores en el formato pedido, mientras que uno que solo
+     * entiende JSON no pudo leer el cuerpo (FastAPI llega a responder 500 en texto plano).
+     */
+    bool
+    format_rejected(const HttpReply& reply, WireFormat sent) {
+        if (sent == WireFormat::Json || reply.error != httplib::Error::Success) {
+            return false;
+        }
+        const bool echoed_format = reply.contentType.rfind(media_type(sent), 0) == 0;
+        if (reply.status != 415 && ((reply.status != 422 && reply.status < 500) || echoed_format)) {
+            return false;
+        }
+        preferred_format_ = WireFormat::Json;
+        if (wire_format_.exchange(WireFormat::Json) != WireFormat::Json) {
+            std::cerr << "Aviso: " << base_api_url_ << " no admite " << media_type(sent)
+                << "; se usará JSON." << std::endl;
+        }
+        return true;
+    }
+
+    void
+    send_single(const std::string& text, const std::string& identifier, Clock::time_point deadline,
+                std::function<void(std::optional<double>)> callback) {
+        nlohmann::json request_json_payload;
+        request_json_payload["texto"] = text;
+        WireFormat format = wire_format_;
+        auto on_reply = [this, text, identifier, deadline, format, callback = std::move(callback)](HttpReply reply) {
+            adopt_advertised_format(reply);
+            if (format_rejected(reply, format)) {
+                send_single(text, identifier, deadline, std::move(callback));
+                return;
+            }
+            std::optional<double> score = parse_single_reply(reply, text, identifier);
+            if (score) {
+                store_score(text, *score);
+            }
+            callback(score);
+        };
+        // La evaluación no tiene efectos en el servidor, así que duplicarla es seguro.
+        if (hedging_) {
+            pool_->submitHedged(api_path_, encode_body(request_json_payload, format), media_type(format),
+                                std::move(on_reply), deadline, media_type(format));
+        } else {
+            pool_->submit(api_path_, encode_body(request_json_payload, format), media_type(format),
+                          std::move(on_reply), deadline, media_type(format));
+        }
+    }
+
+    Clock::time_point
+    resolve_deadline(Clock::time_point deadline) const {
+        return deadline == Clock::time_point() ? Clock::now() + deadline_ : deadline;
+    }
+
+    /**
+     * @brief false (con un aviso) si el cortacircuitos indica que el servidor está caído.
+     */
+    bool
+    api_available() const {
+        if (!pool_->available()) {
+            std::cerr << "Aviso: API de congruencia en " << base_api_url_
+                << (pool_->size() > 1 ? " y los demás servidores" : "")
+                << " no disponible (circuito abierto); se omite." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void
+    report_deadline(Clock::time_point deadline) const {
+        if (Clock::now() >= deadline) {
+            std::cerr << "Aviso: se agotó el plazo de " << deadline_.count()
+                << " ms; se usan solo los resultados obtenidos a tiempo." << std::endl;
+        }
+    }
+
+    std::optional<double>
+    cached_score(const std::string& text) const {
+        return cache_ != nullptr ? cache_->get(ScoreCache::key(model_id_, text)) : std::nullopt;
+    }
+
+    void
+    store_score(const std::string& text, double score) const {
+        if (cache_ != nullptr) {
+            cache_->put(ScoreCache::key(model_id_, text), score);
+        }
+    }
+
+    /**
+     * @brief Interpreta la respuesta del endpoint individual; informa de los errores por stderr.
+     */
+    std::optional<double>
+    parse_single_reply(const HttpReply& reply, const std::string& text_to_evaluate,
+                       const std::string& identifier_for_text) const {
+        if (reply.skipped || reply.expired) {
+            // Circuito abierto o plazo agotado; la operación ya lo notifica.
+            return std::nullopt;
+        }
+        if (reply.error == httplib::Error::Success) {
+            if (reply.status == 200) {
+                try {
+                    nlohmann::json response_json = decode_body(reply);
+                    if (response_json.contains("puntuacion_congruencia")) {
+                        return response_json["puntuacion_congruencia"].get<double>();
+                    } else {
+                        std::cerr << "Warn: 'puntuacion_congruencia' no hallada para \"" << text_to_evaluate <<
+                            "\". ID: " << identifier_for_text << ". Resp: " << (reply.body.size() > 80
+                                ? reply.body.substr(0, 80) + "..."
+                                : reply.body) << std::endl;
+                    }
+                } catch (const nlohmann::json::parse_error& e) {
+                    std::cerr << "Error JSON parse (" << text_to_evaluate << ", ID: " << identifier_for_text <<
+                        "): " << e.what() << ". Body: " << (reply.body.size() > 80
+                            ? reply.body.substr(0, 80) + "..."
+                            : reply.body) << std::endl;
+                } catch (const nlohmann::json::type_error& e) {
+                    std::cerr << "Error JSON type (" << text_to_evaluate << ", ID: " << identifier_for_text << "): "
+                        << e.what() << ". Body: " << (reply.body.size() > 80
+                            ? reply.body.substr(0, 80) + "..."
+                            : reply.body) << std::endl;
+                }
+            } else {
+                // Los errores pueden venir en CBOR o MessagePack; se muestran como JSON.
+                std::string body = reply.body;
+                try {
+                    body = decode_body(reply).dump();
+                } catch (const nlohmann::json::exception&) {
+                }
+                std::cerr << "Error API (" << text_to_evaluate << ", ID: " << identifier_for_text << "): status " <<
+                    reply.status << ". Resp: " << (body.size() > 80
+                        ? body.substr(0, 80) + "..."
+                        : body) << std::endl;
+            }
+        } else {
+            auto err_code = reply.error;
+            std::cerr << "Error HTTP lib (" << text_to_evaluate << ", ID: " << identifier_for_text << "): " <<
+                httplib::to_string(err_code) << (
+                    err_code == httplib::Error::Connection && base_api_url_.rfind("http://localhost", 0) == 0
+                    ? " (Verifique servidor en " + base_api_url_ + ")"
+                    : "") << std::endl;
+        }
+        return std::nullopt;
+    }
+
     std::string base_api_url_;
     std::string api_path_;
-    std::unique_ptr<httplib::Client> cli_;
+    std::string batch_api_path_;
+    std::atomic<bool> batch_supported_{true};
+    std::string model_id_;
+    ScoreCache* cache_;
+    std::chrono::milliseconds deadline_;
+    std::atomic<WireFormat> preferred_format_{WireFormat::Cbor};
+    std::atomic<WireFormat> wire_format_{WireFormat::Json};
+    std::atomic<bool> hedging_{false};
+    std::unique_ptr<BalancedRequestPool> pool_;
 };
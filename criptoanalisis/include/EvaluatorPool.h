@@ -0,0 +1,132 @@
+#pragma once
+#include "EvaluationIA.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Grupo de evaluadores de congruencia compartido por todo el proceso.
+ * Los EvaluationIA (y su cliente HTTP) solo se crean cuando alguien los pide por primera vez;
+ * cada préstamo es exclusivo y al terminar el evaluador vuelve al grupo para reutilizar su conexión.
+ * Es seguro pedir préstamos desde varios hilos.
+ */
+class EvaluatorPool {
+public:
+    /**
+     * @brief Préstamo exclusivo de un evaluador; lo devuelve al grupo al destruirse.
+     */
+    class Lease {
+    public:
+        Lease() = default;
+
+        Lease(EvaluatorPool* pool, std::string endpoint, std::unique_ptr<EvaluationIA> evaluator) :
+            pool_(pool), endpoint_(std::move(endpoint)), evaluator_(std::move(evaluator)) {
+        }
+
+        Lease(Lease&& other) noexcept = default;
+
+        Lease&
+        operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                release();
+                pool_ = other.pool_;
+                endpoint_ = std::move(other.endpoint_);
+                evaluator_ = std::move(other.evaluator_);
+            }
+            return *this;
+        }
+
+        ~Lease() {
+            release();
+        }
+
+        EvaluationIA*
+        operator->() const {
+            return evaluator_.get();
+        }
+
+        EvaluationIA&
+        operator*() const {
+            return *evaluator_;
+        }
+
+        explicit operator bool() const {
+            return evaluator_ != nullptr;
+        }
+
+    private:
+        void
+        release() {
+            if (pool_ != nullptr && evaluator_) {
+                pool_->giveBack(endpoint_, std::move(evaluator_));
+            }
+            evaluator_.reset();
+        }
+
+        EvaluatorPool* pool_ = nullptr;
+        std::string endpoint_;
+        std::unique_ptr<EvaluationIA> evaluator_;
+    };
+
+    /**
+     * @brief El grupo del proceso.
+     */
+    static EvaluatorPool&
+    instance() {
+        static EvaluatorPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Presta un evaluador para el servidor indicado, creándolo si no hay ninguno libre.
+     * @param base_api_url URL base del servidor de congruencia.
+     * @param api_path Ruta del endpoint de evaluación.
+     * @return El préstamo del evaluador.
+     * @throws std::runtime_error Si el cliente HTTP no se puede crear.
+     */
+    Lease
+    acquire(const std::string& base_api_url = "http://localhost:8000",
+            const std::string& api_path = "/evaluar_congruencia/") {
+        std::string endpoint = base_api_url + api_path;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& idle = idle_[endpoint];
+            if (!idle.empty()) {
+                std::unique_ptr<EvaluationIA> evaluator = std::move(idle.back());
+                idle.pop_back();
+                return Lease(this, endpoint, std::move(evaluator));
+            }
+        }
+        // La creación (y su posible error) ocurre fuera del candado.
+        return Lease(this, endpoint, std::make_unique<EvaluationIA>(base_api_url, api_path));
+    }
+
+    /**
+     * @brief Número de evaluadores libres de todos los servidores.
+     */
+    size_t
+    idleCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (const auto& entry : idle_) {
+            count += entry.second.size();
+        }
+        return count;
+    }
+
+private:
+    // Evaluadores libres que se conservan por servidor; el resto se destruye al devolverlos.
+    static constexpr size_t MAX_IDLE_PER_ENDPOINT = 8;
+
+    EvaluatorPool() = default;
+
+    void
+    giveBack(const std::string& endpoint, std::unique_ptr<EvaluationIA> evaluator) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& idle = idle_[endpoint];
+        if (idle.size() < MAX_IDLE_PER_ENDPOINT) {
+            idle.push_back(std::move(evaluator));
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<EvaluationIA>>> idle_;
+};
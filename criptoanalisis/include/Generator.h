@@ -0,0 +1,103 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @brief Generador perezoso basado en corrutinas de C++20: el cuerpo de la corrutina avanza hasta
+ * el siguiente co_yield solo cuando se pide un valor con next(), en el hilo que lo pide.
+ * Solo se puede mover. Las corrutinas generadoras deben recibir sus parámetros por valor.
+ */
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        std::optional<T> current;
+        std::exception_ptr exception;
+
+        Generator
+        get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always
+        initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always
+        final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always
+        yield_value(T value) {
+            current = std::move(value);
+            return {};
+        }
+
+        void
+        return_void() {
+        }
+
+        void
+        unhandled_exception() {
+            exception = std::current_exception();
+        }
+    };
+
+    Generator(Generator&& other) noexcept :
+        handle_(std::exchange(other.handle_, nullptr)) {
+    }
+
+    Generator&
+    operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    /**
+     * @brief Ejecuta la corrutina hasta el siguiente valor.
+     * @return false si ya no hay más valores.
+     * @throws La excepción que haya lanzado la corrutina.
+     */
+    bool
+    next() {
+        if (!handle_ || handle_.done()) {
+            return false;
+        }
+        handle_.promise().current.reset();
+        handle_.resume();
+        if (handle_.promise().exception) {
+            std::rethrow_exception(std::exchange(handle_.promise().exception, nullptr));
+        }
+        return !handle_.done();
+    }
+
+    /**
+     * @brief El último valor producido; se puede mover fuera de él.
+     */
+    T&
+    value() {
+        return *handle_.promise().current;
+    }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) :
+        handle_(handle) {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
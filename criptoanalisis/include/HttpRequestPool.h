@@ -0,0 +1,265 @@
+#pragma once
+#include "CircuitBreaker.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Respuesta de una petición del grupo de conexiones.
+ */
+struct HttpReply {
+    httplib::Error error = httplib::Error::Success;
+    int status = 0;
+    std::string body;
+    std::string contentType;
+    std::string acceptPost;  // formatos de cuerpo que el servidor anuncia (cabecera Accept-Post)
+    bool skipped = false;  // no llegó a enviarse: circuito abierto o grupo destruido
+    bool expired = false;  // se agotó el plazo del llamador, antes o durante el envío
+    double seconds = 0.0;  // duración del envío y la respuesta, sin la espera en la cola
+
+    bool
+    ok() const {
+        return error == httplib::Error::Success && status == 200;
+    }
+};
+
+/**
+ * @brief Grupo de conexiones HTTP persistentes (keep-alive) contra un mismo servidor.
+ * Cada conexión tiene su propio hilo y su propio httplib::Client, así que hay como mucho
+ * 'connections' peticiones en curso; el resto espera en una cola. Las respuestas se entregan
+ * como futuros o mediante callbacks, en el orden en que terminan.
+ * Los hilos y las conexiones se crean con la primera petición.
+ * Cada petición puede llevar un plazo límite: sus tiempos de espera se recortan a lo que quede de él y,
+ * si ya venció al salir de la cola, no se envía. Con un cortacircuitos, las peticiones se omiten mientras
+ * el servidor esté marcado como caído.
+ */
+class HttpRequestPool {
+public:
+    using Callback = std::function<void(HttpReply)>;
+    using Clock = std::chrono::steady_clock;
+    using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+    /**
+     * @param base_url URL base del servidor (p. ej. "http://localhost:8000").
+     * @param connections Número de conexiones persistentes (= peticiones simultáneas).
+     * @param breaker Cortacircuitos del servidor (opcional).
+     * @throws std::runtime_error Si la URL no es válida.
+     */
+    HttpRequestPool(const std::string& base_url, size_t connections = 4,
+                    std::shared_ptr<CircuitBreaker> breaker = nullptr) :
+        base_url_(base_url), connections_(std::max<size_t>(1, connections)), breaker_(std::move(breaker)) {
+        if (!httplib::Client(base_url_).is_valid()) {
+            throw std::runtime_error("Error: URL API '" + base_url_ + "' inválida o fallo inicialización cliente HTTP.");
+        }
+    }
+
+    ~HttpRequestPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        // Las peticiones que no llegaron a enviarse se cancelan.
+        for (auto& task : queue_) {
+            HttpReply reply;
+            reply.error = httplib::Error::Canceled;
+            reply.skipped = true;
+            task.callback(std::move(reply));
+        }
+    }
+
+    HttpRequestPool(const HttpRequestPool&) = delete;
+    HttpRequestPool& operator=(const HttpRequestPool&) = delete;
+
+    /**
+     * @brief Encola un POST; 'callback' se llama desde un hilo del grupo al terminar.
+     * El callback no debe esperar a otra petición del mismo grupo.
+     * @param deadline Momento a partir del cual la petición ya no interesa.
+     * @param accept Cabecera Accept (vacía para no enviarla).
+     * @param cancelled Si se activa antes de que la petición salga de la cola, no se envía
+     * (el callback recibe una respuesta 'skipped').
+     */
+    void
+    submit(const std::string& path, std::string body, const std::string& content_type, Callback callback,
+           Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "",
+           CancelFlag cancelled = nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (workers_.empty()) {
+                for (size_t i = 0; i < connections_; ++i) {
+                    workers_.emplace_back([this]() { workerLoop(); });
+                }
+            }
+            queue_.push_back({path, std::move(body), content_type, std::move(callback), deadline, accept,
+                              std::move(cancelled)});
+            ++outstanding_;
+        }
+        work_ready_.notify_one();
+    }
+
+    /**
+     * @brief Encola un POST y devuelve un futuro con su respuesta.
+     */
+    std::future<HttpReply>
+    submit(const std::string& path, std::string body, const std::string& content_type,
+           Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "") {
+        auto promise = std::make_shared<std::promise<HttpReply>>();
+        std::future<HttpReply> future = promise->get_future();
+        submit(path, std::move(body), content_type,
+               [promise](HttpReply reply) { promise->set_value(std::move(reply)); }, deadline, accept);
+        return future;
+    }
+
+    /**
+     * @brief POST síncrono a través del grupo.
+     */
+    HttpReply
+    post(const std::string& path, std::string body, const std::string& content_type,
+         Clock::time_point deadline = Clock::time_point::max(), const std::string& accept = "") {
+        return submit(path, std::move(body), content_type, deadline, accept).get();
+    }
+
+    /**
+     * @brief Peticiones encoladas o en curso.
+     */
+    size_t
+    outstanding() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return outstanding_;
+    }
+
+    size_t
+    connections() const {
+        return connections_;
+    }
+
+    const std::string&
+    base_url() const {
+        return base_url_;
+    }
+
+private:
+    struct Task {
+        std::string path;
+        std::string body;
+        std::string contentType;
+        Callback callback;
+        Clock::time_point deadline;
+        std::string accept;
+        CancelFlag cancelled;
+    };
+
+    static constexpr std::chrono::seconds CONNECTION_TIMEOUT{5};
+    static constexpr std::chrono::seconds IO_TIMEOUT{10};
+
+    std::unique_ptr<httplib::Client>
+    makeClient() const {
+        auto client = std::make_unique<httplib::Client>(base_url_);
+        client->set_keep_alive(true);
+        client->set_connection_timeout(CONNECTION_TIMEOUT);
+        client->set_read_timeout(IO_TIMEOUT);
+        client->set_write_timeout(IO_TIMEOUT);
+        return client;
+    }
+
+    /**
+     * @brief Envía la petición respetando su plazo y el cortacircuitos, e informa a este del resultado.
+     */
+    HttpReply
+    send(httplib::Client& client, const Task& task) {
+        HttpReply reply;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(task.deadline - Clock::now());
+        if (task.deadline != Clock::time_point::max() && remaining.count() <= 0) {
+            reply.error = httplib::Error::ConnectionTimeout;
+            reply.expired = true;
+            return reply;
+        }
+        if (task.cancelled && *task.cancelled) {
+            reply.error = httplib::Error::Canceled;
+            reply.skipped = true;
+            return reply;
+        }
+        if (breaker_ && !breaker_->allowRequest()) {
+            reply.error = httplib::Error::Canceled;
+            reply.skipped = true;
+            return reply;
+        }
+
+        if (task.deadline != Clock::time_point::max()) {
+            client.set_connection_timeout(std::min<std::chrono::milliseconds>(CONNECTION_TIMEOUT, remaining));
+            client.set_max_timeout(remaining);
+        } else {
+            client.set_connection_timeout(CONNECTION_TIMEOUT);
+            client.set_max_timeout(std::chrono::milliseconds(0));
+        }
+        httplib::Headers headers;
+        if (!task.accept.empty()) {
+            headers.emplace("Accept", task.accept);
+        }
+        auto start_time = Clock::now();
+        auto res = client.Post(task.path, headers, task.body, task.contentType);
+        reply.seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+        if (res) {
+            reply.status = res->status;
+            reply.body = std::move(res->body);
+            reply.contentType = res->get_header_value("Content-Type");
+            reply.acceptPost = res->get_header_value("Accept-Post");
+        } else {
+            reply.error = res.error();
+        }
+        reply.expired = reply.error != httplib::Error::Success && Clock::now() >= task.deadline;
+        // Un 5xx que no viene en el formato binario enviado suele ser un servidor que no entiende ese
+        // formato (el llamador repite la petición en JSON), no un servidor caído. Uvicorn cierra esa
+        // conexión tras el error, así que no se reutiliza.
+        const bool format_mismatch = reply.status >= 500 && task.contentType != "application/json"
+            && task.accept == task.contentType && reply.contentType.rfind(task.contentType, 0) != 0;
+        if (format_mismatch) {
+            client.stop();
+        }
+        if (breaker_) {
+            if (reply.expired) {
+                breaker_->recordAbandoned();
+            } else if (reply.error != httplib::Error::Success || (reply.status >= 500 && !format_mismatch)) {
+                breaker_->recordFailure();
+            } else {
+                breaker_->recordSuccess();
+            }
+        }
+        return reply;
+    }
+
+    void
+    workerLoop() {
+        std::unique_ptr<httplib::Client> client = makeClient();
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_ready_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (stopping_) {
+                    return;
+                }
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            HttpReply reply = send(*client, task);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --outstanding_;
+            }
+            task.callback(std::move(reply));
+        }
+    }
+
+    std::string base_url_;
+    size_t connections_;
+    std::shared_ptr<CircuitBreaker> breaker_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::deque<Task> queue_;
+    std::vector<std::thread> workers_;
+    size_t outstanding_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,154 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @brief Puntuación de un desplazamiento César candidato.
+ */
+struct ShiftScore {
+    int key;
+    double score;
+
+    bool operator<(const ShiftScore& other) const {
+        return score > other.score;
+    }
+};
+
+/**
+ * @brief Análisis de frecuencia de letras contra el perfil del español.
+ * El texto se recorre una sola vez para construir el histograma; después cada desplazamiento
+ * se puntúa rotando el histograma (26 x 26 operaciones), sin descifrar el texto.
+ */
+class LetterFrequency {
+public:
+    using Histogram = std::array<uint64_t, 26>;
+
+    /**
+     * @brief Frecuencia relativa (%) de cada letra a-z en español (sin contar la ñ).
+     */
+    static const std::array<double, 26>&
+    spanishFrequencies() {
+        static const std::array<double, 26> frequencies = {
+            12.53, 1.42, 4.68, 5.86, 13.68, 0.69, 1.01, 0.70, 6.25, 0.44, 0.02, 4.97, 3.15,
+            6.71, 8.68, 2.51, 0.88, 6.87, 7.98, 4.63, 3.93, 0.90, 0.01, 0.22, 0.90, 0.52
+        };
+        return frequencies;
+    }
+
+    /**
+     * @brief Cuenta las letras A-Z/a-z del texto sin distinguir mayúsculas.
+     * @param texto El texto a analizar.
+     * @return El número de apariciones de cada letra.
+     */
+    static Histogram
+    histogram(const std::string& texto) {
+        return histogram(texto.data(), texto.size());
+    }
+
+    /**
+     * @brief Cuenta las letras de un bloque de memoria sin distinguir mayúsculas.
+     */
+    static Histogram
+    histogram(const char* data, size_t length) {
+        Histogram counts{};
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char letter = static_cast<unsigned char>(data[i]) | 0x20;
+            if (letter >= 'a' && letter <= 'z') {
+                ++counts[letter - 'a'];
+            }
+        }
+        return counts;
+    }
+
+    /**
+     * @brief Log-verosimilitud de que el texto con este histograma sea español,
+     * suponiendo que la letra cifrada (i + desplazamiento) % 26 proviene de la letra i.
+     * @param counts Histograma del texto cifrado.
+     * @param shift El desplazamiento (clave original) supuesto.
+     */
+    static double
+    scoreShift(const Histogram& counts, int shift) {
+        const auto& log_probabilities = logFrequencies();
+        double score = 0.0;
+        for (int letter = 0; letter < 26; ++letter) {
+            score += counts[(letter + shift) % 26] * log_probabilities[letter];
+        }
+        return score;
+    }
+
+    /**
+     * @brief Ordena los 26 desplazamientos por su puntuación y devuelve los 'topK' mejores.
+     * @param counts Histograma del texto cifrado.
+     * @param topK Número de desplazamientos a devolver.
+     */
+    static std::vector<ShiftScore>
+    rankShifts(const Histogram& counts, size_t topK = 26) {
+        std::vector<ShiftScore> scores;
+        scores.reserve(26);
+        for (int shift = 0; shift < 26; ++shift) {
+            scores.push_back({shift, scoreShift(counts, shift)});
+        }
+        topK = std::min<size_t>(topK, scores.size());
+        std::partial_sort(scores.begin(), scores.begin() + topK, scores.end());
+        scores.resize(topK);
+        return scores;
+    }
+
+    /**
+     * @brief Desplazamiento más probable para un histograma dado (sin reservar memoria).
+     * Cada letra presente suma su fila de la tabla transpuesta a las 26 puntuaciones a la vez,
+     * un bucle contiguo que el compilador vectoriza; las letras ausentes no cuestan nada.
+     */
+    static int
+    bestShift(const Histogram& counts) {
+        const auto& by_cipher = shiftLogFrequencies();
+        alignas(32) std::array<float, 32> scores{};
+        for (int cipher = 0; cipher < 26; ++cipher) {
+            if (counts[cipher] == 0) {
+                continue;
+            }
+            const float count = static_cast<float>(counts[cipher]);
+            const float* row = by_cipher[cipher].data();
+            for (int shift = 0; shift < 32; ++shift) {
+                scores[shift] += count * row[shift];
+            }
+        }
+        int best = 0;
+        for (int shift = 1; shift < 26; ++shift) {
+            if (scores[shift] > scores[best]) {
+                best = shift;
+            }
+        }
+        return best;
+    }
+
+private:
+    static const std::array<double, 26>&
+    logFrequencies() {
+        static const std::array<double, 26> log_probabilities = []() {
+            std::array<double, 26> values{};
+            for (int letter = 0; letter < 26; ++letter) {
+                values[letter] = std::log(spanishFrequencies()[letter] / 100.0);
+            }
+            return values;
+        }();
+        return log_probabilities;
+    }
+
+    /**
+     * @brief Fila 'cipher': log-probabilidad de la letra plana que corresponde a esa letra cifrada con cada
+     * desplazamiento (26 valores y relleno hasta 32).
+     */
+    static const std::array<std::array<float, 32>, 26>&
+    shiftLogFrequencies() {
+        static const std::array<std::array<float, 32>, 26> table = []() {
+            std::array<std::array<float, 32>, 26> values{};
+            for (int cipher = 0; cipher < 26; ++cipher) {
+                for (int shift = 0; shift < 26; ++shift) {
+                    values[cipher][shift] = static_cast<float>(logFrequencies()[(cipher + 26 - shift) % 26]);
+                }
+            }
+            return values;
+        }();
+        return table;
+    }
+};
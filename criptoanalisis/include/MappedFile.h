@@ -0,0 +1,225 @@
+#pragma once
+#include "Prerequisites.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Archivo proyectado en memoria (mmap en POSIX, MapViewOfFile en Windows).
+ * Se usa para tablas grandes que no caben en RAM o que deben sobrevivir entre ejecuciones.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile&
+    operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = other.data_;
+            size_ = other.size_;
+            writable_ = other.writable_;
+#ifdef _WIN32
+            file_ = other.file_;
+            mapping_ = other.mapping_;
+            other.file_ = INVALID_HANDLE_VALUE;
+            other.mapping_ = nullptr;
+#else
+            fd_ = other.fd_;
+            other.fd_ = -1;
+#endif
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Proyecta un archivo existente en modo solo lectura.
+     * @param path Ruta del archivo.
+     * @throws std::runtime_error Si el archivo no existe o no se puede proyectar.
+     */
+    void
+    openReadOnly(const std::string& path) {
+        open(path, 0, false);
+    }
+
+    /**
+     * @brief Crea (o trunca) un archivo del tamaño indicado y lo proyecta en lectura/escritura.
+     * @param path Ruta del archivo.
+     * @param size Tamaño en bytes.
+     * @throws std::runtime_error Si no se puede crear o proyectar.
+     */
+    void
+    create(const std::string& path, size_t size) {
+        open(path, size, true);
+    }
+
+    /**
+     * @brief Proyecta un archivo en lectura/escritura, creándolo si no existe y ampliándolo a 'minSize' si es menor.
+     * @param path Ruta del archivo.
+     * @param minSize Tamaño mínimo en bytes.
+     */
+    void
+    openReadWrite(const std::string& path, size_t minSize) {
+        open(path, minSize, true, false);
+    }
+
+    /**
+     * @brief Libera la proyección y cierra el archivo.
+     */
+    void
+    close() {
+#ifdef _WIN32
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Fuerza la escritura a disco de las páginas modificadas.
+     */
+    void
+    flush() {
+        if (data_ == nullptr || !writable_) {
+            return;
+        }
+#ifdef _WIN32
+        FlushViewOfFile(data_, 0);
+#else
+        msync(data_, size_, MS_SYNC);
+#endif
+    }
+
+    bool
+    isOpen() const {
+        return data_ != nullptr;
+    }
+
+    void*
+    data() {
+        return data_;
+    }
+
+    const void*
+    data() const {
+        return data_;
+    }
+
+    size_t
+    size() const {
+        return size_;
+    }
+
+private:
+    void
+    open(const std::string& path, size_t size, bool writable, bool truncate = true) {
+        close();
+        writable_ = writable;
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(),
+                            writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                            FILE_SHARE_READ | (writable ? 0 : FILE_SHARE_WRITE),
+                            nullptr,
+                            writable ? (truncate ? CREATE_ALWAYS : OPEN_ALWAYS) : OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("No se pudo abrir el archivo proyectado: " + path);
+        }
+        LARGE_INTEGER current_size;
+        GetFileSizeEx(file_, &current_size);
+        size_t mapped_size = static_cast<size_t>(current_size.QuadPart);
+        if (writable && mapped_size < size) {
+            mapped_size = size;
+        }
+        if (mapped_size == 0) {
+            close();
+            throw std::runtime_error("El archivo proyectado está vacío: " + path);
+        }
+        uint64_t mapped_size64 = static_cast<uint64_t>(mapped_size);
+        mapping_ = CreateFileMappingA(file_, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                      static_cast<DWORD>(mapped_size64 >> 32),
+                                      static_cast<DWORD>(mapped_size64 & 0xFFFFFFFF), nullptr);
+        if (mapping_ == nullptr) {
+            close();
+            throw std::runtime_error("No se pudo crear la proyección del archivo: " + path);
+        }
+        data_ = MapViewOfFile(mapping_, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, mapped_size);
+#else
+        int flags = writable ? (O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0)) : O_RDONLY;
+        fd_ = ::open(path.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("No se pudo abrir el archivo proyectado: " + path);
+        }
+        struct stat info;
+        fstat(fd_, &info);
+        size_t mapped_size = static_cast<size_t>(info.st_size);
+        if (writable && mapped_size < size) {
+            if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+                close();
+                throw std::runtime_error("No se pudo ampliar el archivo proyectado: " + path);
+            }
+            mapped_size = size;
+        }
+        if (mapped_size == 0) {
+            close();
+            throw std::runtime_error("El archivo proyectado está vacío: " + path);
+        }
+        void* mapped = mmap(nullptr, mapped_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                            MAP_SHARED, fd_, 0);
+        data_ = mapped == MAP_FAILED ? nullptr : mapped;
+#endif
+        if (data_ == nullptr) {
+            close();
+            throw std::runtime_error("No se pudo proyectar el archivo en memoria: " + path);
+        }
+        size_ = mapped_size;
+    }
+
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
@@ -0,0 +1,243 @@
+#pragma once
+#include "LetterFrequency.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Candidato del ranking de cifrados monoalfabéticos.
+ */
+struct FamilyCandidate {
+    std::string family;   // "Cesar", "Afin", "Atbash" o "ROT47"
+    int a = 1;            // multiplicador (solo afín; 1 en César)
+    int b = 0;            // desplazamiento
+    double score = 0.0;
+    std::string plaintext;
+
+    bool operator<(const FamilyCandidate& other) const {
+        return score > other.score;
+    }
+};
+
+/**
+ * @brief Criptoanálisis conjunto de las familias monoalfabéticas sencillas: afín (312 claves, que incluyen
+ * César y Atbash) y ROT47.
+ * El texto se recorre una sola vez para construir su histograma de bytes; cada clave se puntúa
+ * permutando los índices del histograma contra un perfil del español, y solo se descifran las mejores.
+ */
+class MonoalphabeticFamilies {
+public:
+    using ByteHistogram = std::array<uint64_t, 256>;
+    using ByteMap = std::array<unsigned char, 256>;
+
+    /**
+     * @brief Cifra con el cifrado afín E(x) = (a·x + b) mod 26 sobre las letras.
+     * @throws std::invalid_argument Si 'a' no es coprimo con 26.
+     */
+    static std::string
+    affineEncode(const std::string& texto, int a, int b) {
+        if (modularInverse(a) < 0) {
+            throw std::invalid_argument("El multiplicador afin debe ser coprimo con 26.");
+        }
+        ByteMap map = identityMap();
+        for (int x = 0; x < 26; ++x) {
+            setLetter(map, x, (modulo26(a) * x + modulo26(b)) % 26);
+        }
+        return applyMap(texto, map);
+    }
+
+    /**
+     * @brief Descifra un texto cifrado con el cifrado afín de clave (a, b).
+     */
+    static std::string
+    affineDecode(const std::string& texto, int a, int b) {
+        return applyMap(texto, affineDecodeMap(a, b));
+    }
+
+    /**
+     * @brief Atbash (a ↔ z, b ↔ y, ...); es su propio inverso.
+     */
+    static std::string
+    atbash(const std::string& texto) {
+        return affineDecode(texto, 25, 25);
+    }
+
+    /**
+     * @brief ROT47 sobre los caracteres imprimibles '!'..'~'; es su propio inverso.
+     */
+    static std::string
+    rot47(const std::string& texto) {
+        return applyMap(texto, rot47Map());
+    }
+
+    /**
+     * @brief Histograma de bytes del texto.
+     */
+    static ByteHistogram
+    histogram(const char* data, size_t length) {
+        ByteHistogram counts{};
+        for (size_t i = 0; i < length; ++i) {
+            ++counts[static_cast<unsigned char>(data[i])];
+        }
+        return counts;
+    }
+
+    /**
+     * @brief Log-verosimilitud de que el texto con este histograma, descifrado con 'map', sea español.
+     */
+    static double
+    scoreMap(const ByteHistogram& counts, const ByteMap& map) {
+        const auto& profile = byteLogProfile();
+        double score = 0.0;
+        for (int byte = 0; byte < 256; ++byte) {
+            if (counts[byte] != 0) {
+                score += counts[byte] * profile[map[byte]];
+            }
+        }
+        return score;
+    }
+
+    /**
+     * @brief Puntúa todas las claves afines, Atbash y ROT47 con un único histograma del texto
+     * y descifra los 'topK' mejores candidatos.
+     * @param texto El texto cifrado.
+     * @param topK Número de candidatos a devolver (y descifrar).
+     * @return Los candidatos ordenados de más a menos probable.
+     */
+    static std::vector<FamilyCandidate>
+    crack(const std::string& texto, size_t topK = 5) {
+        const ByteHistogram counts = histogram(texto.data(), texto.size());
+
+        std::vector<FamilyCandidate> candidates;
+        candidates.reserve(12 * 26 + 1);
+        for (int a : MULTIPLIERS) {
+            for (int b = 0; b < 26; ++b) {
+                FamilyCandidate candidate;
+                candidate.family = a == 1 ? "Cesar" : (a == 25 && b == 25 ? "Atbash" : "Afin");
+                candidate.a = a;
+                candidate.b = b;
+                candidate.score = scoreMap(counts, affineDecodeMap(a, b));
+                candidates.push_back(candidate);
+            }
+        }
+        FamilyCandidate rot;
+        rot.family = "ROT47";
+        rot.a = 0;
+        rot.b = 47;
+        rot.score = scoreMap(counts, rot47Map());
+        candidates.push_back(rot);
+
+        topK = std::min(topK, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + topK, candidates.end());
+        candidates.resize(topK);
+        for (auto& candidate : candidates) {
+            candidate.plaintext = candidate.family == "ROT47" ? rot47(texto)
+                                                             : affineDecode(texto, candidate.a, candidate.b);
+        }
+        return candidates;
+    }
+
+    /**
+     * @brief Inverso de 'a' módulo 26, o -1 si no existe.
+     */
+    static int
+    modularInverse(int a) {
+        a = modulo26(a);
+        for (int inverse = 1; inverse < 26; ++inverse) {
+            if (a * inverse % 26 == 1) {
+                return inverse;
+            }
+        }
+        return -1;
+    }
+
+private:
+    static constexpr int MULTIPLIERS[12] = {1, 3, 5, 7, 9, 11, 15, 17, 19, 21, 23, 25};
+
+    static int
+    modulo26(int value) {
+        return (value % 26 + 26) % 26;
+    }
+
+    static ByteMap
+    identityMap() {
+        ByteMap map{};
+        for (int byte = 0; byte < 256; ++byte) {
+            map[byte] = static_cast<unsigned char>(byte);
+        }
+        return map;
+    }
+
+    static void
+    setLetter(ByteMap& map, int from, int to) {
+        map['a' + from] = static_cast<unsigned char>('a' + to);
+        map['A' + from] = static_cast<unsigned char>('A' + to);
+    }
+
+    static ByteMap
+    affineDecodeMap(int a, int b) {
+        int inverse = modularInverse(a);
+        if (inverse < 0) {
+            throw std::invalid_argument("El multiplicador afin debe ser coprimo con 26.");
+        }
+        ByteMap map = identityMap();
+        for (int y = 0; y < 26; ++y) {
+            setLetter(map, y, (inverse * (y - modulo26(b) + 26)) % 26);
+        }
+        return map;
+    }
+
+    static const ByteMap&
+    rot47Map() {
+        static const ByteMap map = []() {
+            ByteMap values = identityMap();
+            for (int byte = '!'; byte <= '~'; ++byte) {
+                values[byte] = static_cast<unsigned char>('!' + (byte - '!' + 47) % 94);
+            }
+            return values;
+        }();
+        return map;
+    }
+
+    static std::string
+    applyMap(const std::string& texto, const ByteMap& map) {
+        std::string result(texto.size(), '\0');
+        for (size_t i = 0; i < texto.size(); ++i) {
+            result[i] = static_cast<char>(map[static_cast<unsigned char>(texto[i])]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Log-probabilidad de cada byte en texto español: letras según LetterFrequency (minúsculas
+     * mucho más frecuentes que mayúsculas), espacios y puntuación habituales, y el resto muy improbable.
+     * Los bytes no ASCII no cambian con ninguna clave, así que su valor no afecta al ranking.
+     */
+    static const std::array<double, 256>&
+    byteLogProfile() {
+        static const std::array<double, 256> profile = []() {
+            std::array<double, 256> probability{};
+            probability.fill(1e-6);
+            for (int byte = '!'; byte <= '~'; ++byte) {
+                probability[byte] = 1e-4;
+            }
+            for (int letter = 0; letter < 26; ++letter) {
+                double frequency = std::max(LetterFrequency::spanishFrequencies()[letter], 0.05) / 100.0;
+                probability['a' + letter] = 0.78 * frequency;
+                probability['A' + letter] = 0.03 * frequency;
+            }
+            probability[' '] = 0.15;
+            probability['\n'] = 0.005;
+            for (char punctuation : std::string(".,;:")) {
+                probability[static_cast<unsigned char>(punctuation)] = 0.006;
+            }
+            for (int digit = '0'; digit <= '9'; ++digit) {
+                probability[digit] = 0.0005;
+            }
+            std::array<double, 256> values{};
+            for (int byte = 0; byte < 256; ++byte) {
+                values[byte] = std::log(probability[byte]);
+            }
+            return values;
+        }();
+        return profile;
+    }
+};
@@ -0,0 +1,291 @@
+#pragma once
+#include "MappedFile.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Modelo de lenguaje de n-gramas de letras (de bigramas a cuadrigramas).
+ * Se entrena con cualquier corpus local, se guarda como tabla binaria de log10-probabilidades
+ * (26^N valores float) y se carga proyectando el archivo en memoria.
+ * Puntuar un texto cuesta una consulta a la tabla por letra.
+ */
+class NGramModel {
+public:
+    NGramModel() = default;
+    ~NGramModel() = default;
+
+    NGramModel(const NGramModel&) = delete;
+    NGramModel& operator=(const NGramModel&) = delete;
+
+    /**
+     * @brief Entrena un modelo a partir de un corpus de texto y lo guarda en disco.
+     * Las letras se pasan a minúsculas, las vocales acentuadas y la ñ (UTF-8) se reducen a su letra base
+     * y el resto de caracteres se ignora.
+     * @param corpusPath Ruta del corpus.
+     * @param outputPath Ruta del archivo binario a generar.
+     * @param order Orden N del modelo (2 a 4).
+     * @return El número de n-gramas contados.
+     * @throws std::runtime_error Si el corpus no se puede leer o es demasiado corto.
+     */
+    static uint64_t
+    train(const std::string& corpusPath, const std::string& outputPath, int order = 4) {
+        if (order < 2 || order > 4) {
+            throw std::invalid_argument("El orden del modelo de n-gramas debe estar entre 2 y 4.");
+        }
+        std::ifstream corpus(corpusPath, std::ios::binary);
+        if (!corpus.is_open()) {
+            throw std::runtime_error("No se pudo abrir el corpus: " + corpusPath);
+        }
+
+        const size_t table_size = tableSize(order);
+        std::vector<uint64_t> counts(table_size, 0);
+        uint64_t total = 0;
+        uint32_t index = 0;
+        int letters_in_window = 0;
+
+        std::vector<char> buffer(1 << 16);
+        unsigned char pending_lead = 0;
+        while (corpus.read(buffer.data(), buffer.size()) || corpus.gcount() > 0) {
+            std::streamsize read = corpus.gcount();
+            for (std::streamsize i = 0; i < read; ++i) {
+                unsigned char c = static_cast<unsigned char>(buffer[i]);
+                int letter = -1;
+                if (pending_lead != 0) {
+                    letter = accentedLetter(pending_lead, c);
+                    pending_lead = 0;
+                } else if (c == 0xC3) {
+                    pending_lead = c;
+                    continue;
+                } else {
+                    letter = letterIndex(c);
+                }
+                if (letter < 0) {
+                    continue;
+                }
+                index = static_cast<uint32_t>((index * 26 + letter) % table_size);
+                if (++letters_in_window >= order) {
+                    ++counts[index];
+                    ++total;
+                }
+            }
+        }
+        if (total == 0) {
+            throw std::runtime_error("El corpus no contiene suficientes letras: " + corpusPath);
+        }
+
+        // Log10-probabilidades; los n-gramas no vistos reciben una probabilidad mínima.
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.order = static_cast<uint32_t>(order);
+        header.floor = static_cast<float>(std::log10(0.01 / static_cast<double>(total)));
+        header.ngrams = total;
+
+        MappedFile file;
+        file.create(outputPath, sizeof(Header) + table_size * sizeof(float));
+        std::memcpy(file.data(), &header, sizeof(Header));
+        float* table = reinterpret_cast<float*>(static_cast<char*>(file.data()) + sizeof(Header));
+        for (size_t i = 0; i < table_size; ++i) {
+            table[i] = counts[i] == 0
+                ? header.floor
+                : static_cast<float>(std::log10(static_cast<double>(counts[i]) / static_cast<double>(total)));
+        }
+        file.flush();
+        return total;
+    }
+
+    /**
+     * @brief Proyecta en memoria un modelo generado con train().
+     * @param path Ruta del archivo del modelo.
+     * @throws std::runtime_error Si el archivo no es un modelo válido.
+     */
+    void
+    load(const std::string& path) {
+        file_.openReadOnly(path);
+        if (file_.size() < sizeof(Header)) {
+            throw std::runtime_error("Modelo de n-gramas truncado: " + path);
+        }
+        std::memcpy(&header_, file_.data(), sizeof(Header));
+        if (std::memcmp(header_.magic, MAGIC, sizeof(header_.magic)) != 0 || header_.order < 2 ||
+            header_.order > 4 || file_.size() < sizeof(Header) + tableSize(header_.order) * sizeof(float)) {
+            file_.close();
+            throw std::runtime_error("Archivo de modelo de n-gramas inválido: " + path);
+        }
+        table_ = reinterpret_cast<const float*>(static_cast<const char*>(file_.data()) + sizeof(Header));
+        table_size_ = static_cast<uint32_t>(tableSize(header_.order));
+    }
+
+    bool
+    isLoaded() const {
+        return table_ != nullptr;
+    }
+
+    int
+    order() const {
+        return static_cast<int>(header_.order);
+    }
+
+    /**
+     * @brief Log10-verosimilitud del texto según el modelo (suma sobre todos sus n-gramas de letras).
+     * Los caracteres que no son letras ASCII se ignoran.
+     * @param data El texto.
+     * @param length Longitud en bytes.
+     */
+    double
+    score(const char* data, size_t length) const {
+        double total = 0.0;
+        uint32_t index = 0;
+        uint32_t letters_in_window = 0;
+        for (size_t i = 0; i < length; ++i) {
+            int letter = letterIndex(static_cast<unsigned char>(data[i]));
+            if (letter < 0) {
+                continue;
+            }
+            index = (index * 26 + static_cast<uint32_t>(letter)) % table_size_;
+            if (++letters_in_window >= header_.order) {
+                total += table_[index];
+            }
+        }
+        return total;
+    }
+
+    double
+    score(const std::string& text) const {
+        return score(text.data(), text.size());
+    }
+
+    /**
+     * @brief Log10-verosimilitud de una secuencia de índices de letra (0-25) ya normalizada.
+     */
+    double
+    scoreIndices(const uint8_t* letters, size_t length) const {
+        double total = 0.0;
+        uint32_t index = 0;
+        for (size_t i = 0; i < length; ++i) {
+            index = (index * 26 + letters[i]) % table_size_;
+            if (i + 1 >= header_.order) {
+                total += table_[index];
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Log10-probabilidad de un n-grama dado por su índice en base 26.
+     */
+    float
+    ngram(uint32_t index) const {
+        return table_[index];
+    }
+
+    /**
+     * @brief Modelo compartido por todo el proceso; se proyecta la primera vez que se pide desde
+     * 'dictionaries/ngramasES.bin'. Devuelve nullptr si no hay modelo entrenado.
+     */
+    static std::shared_ptr<const NGramModel>
+    shared() {
+        std::lock_guard<std::mutex> lock(sharedMutex());
+        auto& model = sharedSlot();
+        if (!model && !sharedLoadAttempted()) {
+            sharedLoadAttempted() = true;
+            auto loaded = std::make_shared<NGramModel>();
+            try {
+                loaded->load(DEFAULT_PATH);
+                model = loaded;
+            } catch (const std::exception&) {
+                // Sin modelo entrenado: los que lo usan vuelven a sus puntuaciones por frecuencia.
+            }
+        }
+        return model;
+    }
+
+    /**
+     * @brief Sustituye el modelo compartido por el que hay en 'path'.
+     * @return true si se cargó; si no, se mantiene el anterior.
+     */
+    static bool
+    loadShared(const std::string& path) {
+        auto loaded = std::make_shared<NGramModel>();
+        try {
+            loaded->load(path);
+        } catch (const std::exception& e) {
+            std::cerr << "ADVERTENCIA (NGram): " << e.what() << std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(sharedMutex());
+        sharedSlot() = loaded;
+        sharedLoadAttempted() = true;
+        return true;
+    }
+
+    /**
+     * @brief Índice 0-25 de una letra ASCII (sin distinguir mayúsculas), o -1 si no es letra.
+     */
+    static int
+    letterIndex(unsigned char c) {
+        unsigned char lower = c | 0x20;
+        return (lower >= 'a' && lower <= 'z') ? lower - 'a' : -1;
+    }
+
+    static constexpr const char* DEFAULT_PATH = "dictionaries/ngramasES.bin";
+
+private:
+    static constexpr char MAGIC[8] = {'N', 'G', 'R', 'A', 'M', 'E', 'S', '1'};
+
+    struct Header {
+        char magic[8];
+        uint32_t order;
+        float floor;
+        uint64_t ngrams;
+    };
+
+    static std::mutex&
+    sharedMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::shared_ptr<const NGramModel>&
+    sharedSlot() {
+        static std::shared_ptr<const NGramModel> model;
+        return model;
+    }
+
+    static bool&
+    sharedLoadAttempted() {
+        static bool attempted = false;
+        return attempted;
+    }
+
+    static size_t
+    tableSize(int order) {
+        size_t size = 1;
+        for (int i = 0; i < order; ++i) {
+            size *= 26;
+        }
+        return size;
+    }
+
+    /**
+     * @brief Letra base de una vocal acentuada o ñ en UTF-8 (segundo byte tras 0xC3).
+     */
+    static int
+    accentedLetter(unsigned char lead, unsigned char c) {
+        if (lead != 0xC3) {
+            return -1;
+        }
+        switch (c | 0x20) {
+        case 0xA1: return 'a' - 'a';
+        case 0xA9: return 'e' - 'a';
+        case 0xAD: return 'i' - 'a';
+        case 0xB3: return 'o' - 'a';
+        case 0xBA:
+        case 0xBC: return 'u' - 'a';
+        case 0xB1: return 'n' - 'a';
+        default: return -1;
+        }
+    }
+
+    MappedFile file_;
+    Header header_{};
+    const float* table_ = nullptr;
+    uint32_t table_size_ = 1;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @brief Ordena [first, last) con varios hilos: cada hilo ordena un tramo y luego
+ * los tramos se fusionan por parejas, también en paralelo.
+ * @param first Inicio del rango.
+ * @param last Fin del rango.
+ * @param comp Comparador estricto.
+ * @param threads Número de hilos (0 = los disponibles en el equipo).
+ */
+template <typename RandomIt, typename Compare>
+void
+parallelSort(RandomIt first, RandomIt last, Compare comp, unsigned int threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t count = static_cast<size_t>(last - first);
+    if (threads == 1 || count < 65536) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds;
+    for (unsigned int i = 0; i <= threads; ++i) {
+        bounds.push_back(count * i / threads);
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i]() { std::sort(first + bounds[i], first + bounds[i + 1], comp); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    while (bounds.size() > 2) {
+        std::vector<size_t> merged_bounds;
+        workers.clear();
+        for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+            size_t lo = bounds[i], mid = bounds[i + 1], hi = bounds[i + 2];
+            workers.emplace_back([=]() { std::inplace_merge(first + lo, first + mid, first + hi, comp); });
+            merged_bounds.push_back(lo);
+        }
+        if (bounds.size() % 2 == 0) {
+            // Tramo impar sin pareja: pasa tal cual a la siguiente ronda.
+            merged_bounds.push_back(bounds[bounds.size() - 2]);
+        }
+        merged_bounds.push_back(bounds.back());
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        bounds = std::move(merged_bounds);
+    }
+}
+
+/**
+ * @brief Fusiona en 'out' los tramos ordenados [first + bounds[i], first + bounds[i + 1]) con un montículo
+ * de cursores (uno por tramo). Cada tramo se lee y la salida se escribe de forma secuencial, así que
+ * sirve para tablas en archivos proyectados mayores que la memoria.
+ * @param first Inicio del rango.
+ * @param bounds Límites de los tramos, crecientes; el último es el fin del rango.
+ * @param out Destino de la fusión (no puede solaparse con el rango).
+ * @param comp Comparador estricto.
+ */
+template <typename RandomIt, typename OutputIt, typename Compare>
+void
+mergeSortedRuns(RandomIt first, const std::vector<size_t>& bounds, OutputIt out, Compare comp) {
+    // Cursor de un tramo: (posición siguiente, fin).
+    using Cursor = std::pair<size_t, size_t>;
+    auto later = [&](const Cursor& a, const Cursor& b) { return comp(first[b.first], first[a.first]); };
+    std::vector<Cursor> heap;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        if (bounds[i] < bounds[i + 1]) {
+            heap.push_back({bounds[i], bounds[i + 1]});
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Cursor& cursor = heap.back();
+        *out++ = first[cursor.first];
+        if (++cursor.first < cursor.second) {
+            std::push_heap(heap.begin(), heap.end(), later);
+        } else {
+            heap.pop_back();
+        }
+    }
+}
@@ -12,6 +12,28 @@
 #include <fstream>
 #include <sstream>
 #include <bitset>
+#include <array>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <limits>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <numeric>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <cstdio>
+#include <optional>
+#include <functional>
+#include <future>
+#include <list>
+#include <coroutine>
+#include <iterator>
 
 // Call API
 #include "libraries/httplib.h"
@@ -0,0 +1,137 @@
+#pragma once
+#include "DES.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Tablas auxiliares del DES simplificado para criptoanálisis.
+ * Se derivan de las funciones públicas de DES, de modo que respetan su orden de bits:
+ * la entrada de 6 bits de cada caja tiene el bit i*6 como bit 0, y la salida de 4 bits
+ * tiene el bit i*4 como bit 0.
+ */
+class DESAnalysis {
+public:
+    /**
+     * @brief Salida de 4 bits de la S-Box para cada entrada de 6 bits (todas las cajas usan la misma SBOX).
+     */
+    static const std::array<uint8_t, 64>&
+    sbox() {
+        static const std::array<uint8_t, 64> table = []() {
+            std::array<uint8_t, 64> values{};
+            DES reference;
+            for (uint64_t input = 0; input < 64; ++input) {
+                auto output = reference.substitute(std::bitset<48>(input));
+                values[input] = static_cast<uint8_t>(output.to_ulong() & 0xF);
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    /**
+     * @brief Aplica la permutación P a un valor de 32 bits.
+     */
+    static uint32_t
+    permuteP(uint32_t input) {
+        const auto& table = permutationTables();
+        uint32_t output = 0;
+        for (int bit = 0; bit < 32; ++bit) {
+            if ((input >> bit) & 1) {
+                output |= 1u << table.forward[bit];
+            }
+        }
+        return output;
+    }
+
+    /**
+     * @brief Aplica la inversa de la permutación P a un valor de 32 bits.
+     */
+    static uint32_t
+    inversePermuteP(uint32_t input) {
+        const auto& table = permutationTables();
+        uint32_t output = 0;
+        for (int bit = 0; bit < 32; ++bit) {
+            if ((input >> bit) & 1) {
+                output |= 1u << table.inverse[bit];
+            }
+        }
+        return output;
+    }
+
+private:
+    struct PermutationTables {
+        std::array<int, 32> forward{};
+        std::array<int, 32> inverse{};
+    };
+
+    static const PermutationTables&
+    permutationTables() {
+        static const PermutationTables tables = []() {
+            PermutationTables result;
+            DES reference;
+            for (int bit = 0; bit < 32; ++bit) {
+                auto permuted = reference.permutedP(std::bitset<32>(1ULL << bit));
+                for (int out = 0; out < 32; ++out) {
+                    if (permuted[out]) {
+                        result.forward[bit] = out;
+                        result.inverse[out] = bit;
+                    }
+                }
+            }
+            return result;
+        }();
+        return tables;
+    }
+};
+
+/**
+ * @brief DES simplificado reducido a 'Rounds' rondas.
+ * El número de rondas es un parámetro de plantilla, así que el bucle de rondas se desenrolla en compilación.
+ * Con Rounds = 16 coincide con DES::encodeBlock().
+ */
+template <int Rounds>
+class ReducedDES {
+    static_assert(Rounds >= 1 && Rounds <= 16, "ReducedDES admite entre 1 y 16 rondas.");
+
+public:
+    static constexpr int ROUNDS = Rounds;
+
+    /**
+     * @brief Codifica un bloque con 'Rounds' rondas (con IP, intercambio final y FP).
+     * @param plaintext El bloque de 64 bits de texto plano.
+     * @param schedule Las subclaves obtenidas con DES::fastSchedule().
+     * @return El bloque de 64 bits cifrado.
+     */
+    static uint64_t
+    encode(uint64_t plaintext, const DES::FastSchedule& schedule) {
+        uint64_t block = DES::iPermutationFast(plaintext);
+        uint32_t left = static_cast<uint32_t>(block >> 32);
+        uint32_t right = static_cast<uint32_t>(block);
+        applyRounds<0>(left, right, schedule);
+        return DES::fPermutationFast((static_cast<uint64_t>(right) << 32) | left);
+    }
+
+    /**
+     * @brief Estado (L, R) tras 'Rounds' rondas, sin intercambio final ni FP.
+     * Útil para medir diferencias o aproximaciones internas.
+     */
+    static uint64_t
+    state(uint64_t plaintext, const DES::FastSchedule& schedule) {
+        uint64_t block = DES::iPermutationFast(plaintext);
+        uint32_t left = static_cast<uint32_t>(block >> 32);
+        uint32_t right = static_cast<uint32_t>(block);
+        applyRounds<0>(left, right, schedule);
+        return (static_cast<uint64_t>(left) << 32) | right;
+    }
+
+private:
+    template <int Round>
+    static void
+    applyRounds(uint32_t& left, uint32_t& right, const DES::FastSchedule& schedule) {
+        if constexpr (Round < Rounds) {
+            uint32_t new_right = left ^ DES::feistelFast(right, schedule[Round]);
+            left = right;
+            right = new_right;
+            applyRounds<Round + 1>(left, right, schedule);
+        }
+    }
+};
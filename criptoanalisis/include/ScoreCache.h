@@ -0,0 +1,204 @@
+#pragma once
+#include "MappedFile.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Caché LRU de puntuaciones de congruencia, direccionada por contenido.
+ * La clave es un hash de 64 bits del identificador del modelo y del texto, así que el mismo texto
+ * evaluado por otro modelo no comparte entrada. Opcionalmente se asocia a un archivo proyectado en
+ * memoria donde cada puntuación nueva se añade al final; al abrirlo se vuelven a cargar todas,
+ * de modo que sobreviven entre ejecuciones. Es segura entre hilos.
+ */
+class ScoreCache {
+public:
+    /**
+     * @param capacity Número máximo de puntuaciones en memoria.
+     */
+    explicit ScoreCache(size_t capacity = 65536) :
+        capacity_(std::max<size_t>(1, capacity)) {
+    }
+
+    ~ScoreCache() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.flush();
+    }
+
+    ScoreCache(const ScoreCache&) = delete;
+    ScoreCache& operator=(const ScoreCache&) = delete;
+
+    /**
+     * @brief La caché compartida por todos los evaluadores del proceso.
+     */
+    static ScoreCache&
+    shared() {
+        static ScoreCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief Hash FNV-1a de 64 bits del modelo y del texto, separados por un byte 0xFF.
+     */
+    static uint64_t
+    key(const std::string& model_id, const std::string& text) {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const std::string& value) {
+            for (unsigned char c : value) {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+        };
+        mix(model_id);
+        hash ^= 0xFF;
+        hash *= 1099511628211ull;
+        mix(text);
+        return hash;
+    }
+
+    /**
+     * @brief Busca una puntuación y, si está, la marca como la más reciente.
+     */
+    std::optional<double>
+    get(uint64_t key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return std::nullopt;
+        }
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    /**
+     * @brief Guarda una puntuación; si hay archivo asociado y la clave es nueva, también la añade a él.
+     */
+    void
+    put(uint64_t key, double score) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (insert(key, score) && file_.isOpen()) {
+            append(key, score);
+        }
+    }
+
+    /**
+     * @brief Asocia la caché a un archivo de persistencia, creándolo si no existe,
+     * y carga en memoria las puntuaciones que ya contenga.
+     * @param path Ruta del archivo.
+     * @throws std::runtime_error Si el archivo existe pero no es una caché de puntuaciones.
+     */
+    void
+    attachFile(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.flush();
+        path_ = path;
+        file_.openReadWrite(path_, sizeof(Header) + INITIAL_RECORDS * sizeof(Record));
+
+        Header* header = static_cast<Header*>(file_.data());
+        if (std::memcmp(header->magic, EMPTY_MAGIC, sizeof(header->magic)) == 0) {
+            std::memcpy(header->magic, MAGIC, sizeof(header->magic));
+            header->count = 0;
+        } else if (std::memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0) {
+            file_.close();
+            throw std::runtime_error("El archivo no es una cache de puntuaciones: " + path);
+        }
+        size_t stored = std::min<size_t>(header->count, recordCapacity());
+        header->count = stored;
+        const Record* records = reinterpret_cast<const Record*>(header + 1);
+        for (size_t i = 0; i < stored; ++i) {
+            insert(records[i].key, records[i].score);
+        }
+    }
+
+    size_t
+    size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+    uint64_t
+    hits() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+    uint64_t
+    misses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+private:
+    static constexpr char MAGIC[8] = {'S', 'C', 'O', 'R', 'E', 'S', '0', '1'};
+    static constexpr char EMPTY_MAGIC[8] = {};
+    static constexpr size_t INITIAL_RECORDS = 4096;
+
+    struct Header {
+        char magic[8];
+        uint64_t count;
+    };
+
+    struct Record {
+        uint64_t key;
+        double score;
+    };
+
+    /**
+     * @brief Inserta o actualiza en el LRU; devuelve true si la clave no estaba.
+     */
+    bool
+    insert(uint64_t key, double score) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = score;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return false;
+        }
+        entries_.emplace_front(key, score);
+        index_[key] = entries_.begin();
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        return true;
+    }
+
+    size_t
+    recordCapacity() const {
+        return (file_.size() - sizeof(Header)) / sizeof(Record);
+    }
+
+    /**
+     * @brief Añade un registro al final del archivo, duplicando su tamaño si está lleno.
+     * Si no se puede ampliar, el archivo se cierra y la caché sigue solo en memoria.
+     * El contador de la cabecera se actualiza después del registro, así que un corte a medias
+     * solo pierde la última puntuación.
+     */
+    void
+    append(uint64_t key, double score) {
+        size_t count = static_cast<Header*>(file_.data())->count;
+        if (count == recordCapacity()) {
+            file_.flush();
+            try {
+                file_.openReadWrite(path_, sizeof(Header) + count * 2 * sizeof(Record));
+            } catch (const std::exception& e) {
+                // Sin espacio o sin permisos: la caché sigue funcionando solo en memoria.
+                std::cerr << "Aviso: se deja de persistir la cache de puntuaciones: " << e.what() << std::endl;
+                return;
+            }
+        }
+        Header* header = static_cast<Header*>(file_.data());
+        Record* records = reinterpret_cast<Record*>(header + 1);
+        records[count] = {key, score};
+        header->count = count + 1;
+    }
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::list<std::pair<uint64_t, double>> entries_;
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, double>>::iterator> index_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    MappedFile file_;
+    std::string path_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+#include "EvaluationIA.h"
+#include "Generator.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Resultado de un mensaje del lote: sus candidatos y los mejores según la API.
+ */
+struct PipelineResult {
+    size_t message;
+    std::vector<std::string> candidates;
+    std::vector<ScoredCandidate> best;
+};
+
+/**
+ * @brief Tubería de evaluación por lotes con corrutinas de C++20.
+ * Un generador produce los candidatos de cada mensaje en el hilo que llama a run(); cada conjunto pasa a
+ * una corrutina de puntuación que se suspende mientras la API responde y se reanuda en un hilo del grupo
+ * de conexiones. Así el descifrado local del mensaje N+1 se solapa con la evaluación remota del mensaje N,
+ * y tanto la CPU como el servidor del modelo se mantienen ocupados. Como mucho hay 'max_in_flight'
+ * mensajes en evaluación; el generador espera si se alcanza ese límite.
+ */
+class ScoringPipeline {
+public:
+    /**
+     * @param evaluator Evaluador usado para todos los mensajes; debe vivir más que la tubería.
+     * @param top_k Resultados que se conservan por mensaje.
+     * @param max_in_flight Mensajes evaluándose a la vez.
+     */
+    ScoringPipeline(EvaluationIA& evaluator, size_t top_k = 3, size_t max_in_flight = 4) :
+        evaluator_(evaluator), top_k_(top_k), max_in_flight_(std::max<size_t>(1, max_in_flight)) {
+    }
+
+    ScoringPipeline(const ScoringPipeline&) = delete;
+    ScoringPipeline& operator=(const ScoringPipeline&) = delete;
+
+    /**
+     * @brief Consume el generador y evalúa cada conjunto de candidatos en cuanto se produce.
+     * @param candidate_sets Generador con los candidatos de cada mensaje, en orden.
+     * @param on_result Opcional; se llama con cada mensaje terminado, en el orden en que terminan
+     * y desde un hilo del grupo (o desde este si todo estaba en la caché). No debe bloquear.
+     * @return Los resultados de todos los mensajes, en el orden del generador.
+     */
+    std::vector<PipelineResult>
+    run(Generator<std::vector<std::string>> candidate_sets,
+        std::function<void(const PipelineResult&)> on_result = nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_.clear();
+            on_result_ = std::move(on_result);
+        }
+        size_t message = 0;
+        while (candidate_sets.next()) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                slot_ready_.wait(lock, [this]() { return in_flight_ < max_in_flight_; });
+                ++in_flight_;
+            }
+            score(message++, std::move(candidate_sets.value()));
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        slot_ready_.wait(lock, [this]() { return in_flight_ == 0; });
+        std::vector<PipelineResult> results = std::move(results_);
+        std::sort(results.begin(), results.end(),
+                  [](const PipelineResult& a, const PipelineResult& b) { return a.message < b.message; });
+        return results;
+    }
+
+private:
+    /**
+     * @brief Corrutina sin valor de retorno que empieza al llamarla y se destruye sola al terminar.
+     */
+    struct Detached {
+        struct promise_type {
+            Detached
+            get_return_object() {
+                return {};
+            }
+
+            std::suspend_never
+            initial_suspend() noexcept {
+                return {};
+            }
+
+            std::suspend_never
+            final_suspend() noexcept {
+                return {};
+            }
+
+            void
+            return_void() {
+            }
+
+            void
+            unhandled_exception() {
+                std::terminate();
+            }
+        };
+    };
+
+    /**
+     * @brief Operación esperable con co_await: evalúa los candidatos sin bloquear y reanuda la
+     * corrutina (en el hilo que entrega la última puntuación) con los mejores resultados.
+     */
+    struct Evaluation {
+        EvaluationIA& evaluator;
+        const std::vector<std::string>& texts;
+        size_t top_k;
+        std::vector<ScoredCandidate> best;
+
+        bool
+        await_ready() const noexcept {
+            return false;
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> handle) {
+            // La reanudación es lo último que hace el evaluador con este objeto y con 'texts'.
+            evaluator.evaluate_async(texts, top_k, nullptr, [this, handle](std::vector<ScoredCandidate> result) {
+                best = std::move(result);
+                handle.resume();
+            });
+        }
+
+        std::vector<ScoredCandidate>
+        await_resume() {
+            return std::move(best);
+        }
+    };
+
+    /**
+     * @brief Corrutina de puntuación de un mensaje; los candidatos viven en su marco hasta que termina.
+     */
+    Detached
+    score(size_t message, std::vector<std::string> candidates) {
+        PipelineResult result{message, std::move(candidates), {}};
+        result.best = co_await Evaluation{evaluator_, result.candidates, top_k_, {}};
+        finish(std::move(result));
+    }
+
+    void
+    finish(PipelineResult result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (on_result_) {
+            on_result_(result);
+        }
+        results_.push_back(std::move(result));
+        --in_flight_;
+        slot_ready_.notify_all();
+    }
+
+    EvaluationIA& evaluator_;
+    size_t top_k_;
+    size_t max_in_flight_;
+    std::mutex mutex_;
+    std::condition_variable slot_ready_;
+    std::vector<PipelineResult> results_;
+    std::function<void(const PipelineResult&)> on_result_;
+    size_t in_flight_ = 0;
+};
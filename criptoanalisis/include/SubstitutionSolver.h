@@ -0,0 +1,333 @@
+#pragma once
+#include "NGramModel.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Parámetros del recocido simulado.
+ */
+struct SubstitutionSolverConfig {
+    unsigned int threads = 0;
+    unsigned int restarts = 16;
+    unsigned int iterationsPerRestart = 30000;
+    double initialTemperature = 0.02;
+    double finalTemperature = 0.001;
+    uint64_t seed = 0;
+};
+
+/**
+ * @brief Resultado del solucionador de sustitución monoalfabética.
+ */
+struct SubstitutionSolverResult {
+    // Letra plana de cada letra cifrada ('a'..'z'): plano = key[cifrado - 'a'].
+    std::string key;
+    std::string plaintext;
+    double score = 0.0;
+    unsigned int restarts = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Criptoanálisis de sustitución monoalfabética por recocido simulado sobre permutaciones.
+ * La aptitud es la log-verosimilitud del texto según un modelo de n-gramas. Los n-gramas del texto
+ * cifrado se agrupan (distintos y con su número de apariciones) y cada letra cifrada guarda la lista
+ * de n-gramas en los que aparece: intercambiar dos letras de la clave solo vuelve a puntuar esas listas.
+ * Los reinicios se reparten entre los hilos, que comparten la mejor clave encontrada.
+ */
+class SubstitutionSolver {
+public:
+    using Key = std::array<uint8_t, 26>;
+
+    SubstitutionSolver(const NGramModel& model, const SubstitutionSolverConfig& config = SubstitutionSolverConfig()) :
+        model_(model), config_(config),
+        threads_(config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+
+    ~SubstitutionSolver() = default;
+
+    /**
+     * @brief Cifra o descifra con una clave de sustitución conservando mayúsculas y el resto de caracteres.
+     * @param texto El texto de entrada.
+     * @param key Alfabeto de 26 letras: la letra i se sustituye por key[i].
+     */
+    static std::string
+    apply(const std::string& texto, const std::string& key) {
+        if (key.size() != 26) {
+            throw std::invalid_argument("La clave de sustitucion debe tener 26 letras.");
+        }
+        std::string result = texto;
+        for (char& c : result) {
+            int letter = NGramModel::letterIndex(static_cast<unsigned char>(c));
+            if (letter >= 0) {
+                char mapped = static_cast<char>(key[letter] | 0x20);
+                c = (c >= 'A' && c <= 'Z') ? static_cast<char>(mapped - 'a' + 'A') : mapped;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Clave inversa (la que deshace la sustitución de 'key').
+     */
+    static std::string
+    invert(const std::string& key) {
+        std::string inverse(26, '?');
+        for (int i = 0; i < 26; ++i) {
+            inverse[(key[i] | 0x20) - 'a'] = static_cast<char>('a' + i);
+        }
+        return inverse;
+    }
+
+    /**
+     * @brief Busca la clave de descifrado que maximiza la aptitud del texto.
+     * @param ciphertext El texto cifrado.
+     * @return La mejor clave encontrada y el texto descifrado.
+     * @throws std::invalid_argument Si el modelo no está cargado o el texto es demasiado corto.
+     */
+    SubstitutionSolverResult
+    solve(const std::string& ciphertext) const {
+        if (!model_.isLoaded()) {
+            throw std::invalid_argument("El solucionador de sustitucion necesita un modelo de n-gramas cargado.");
+        }
+        auto start_time = std::chrono::steady_clock::now();
+        const Ngrams ngrams = collectNgrams(ciphertext);
+        if (ngrams.count.empty()) {
+            throw std::invalid_argument("El texto cifrado es demasiado corto para el modelo de n-gramas.");
+        }
+
+        std::mutex best_mutex;
+        Key best_key = frequencyKey(ciphertext);
+        double best_score = fullScore(ngrams, best_key);
+        std::atomic<unsigned int> next_restart{0};
+
+        auto worker = [&](unsigned int thread_index) {
+            std::mt19937_64 rng(config_.seed != 0 ? config_.seed + thread_index
+                                                  : std::random_device{}() ^ (uint64_t(thread_index) << 32));
+            std::vector<uint32_t> indices(ngrams.count.size());
+            for (unsigned int restart = next_restart.fetch_add(1); restart < config_.restarts;
+                 restart = next_restart.fetch_add(1)) {
+                // Los reinicios pares parten de una clave aleatoria; los impares, de la mejor compartida.
+                Key key;
+                if (restart % 2 == 0) {
+                    std::iota(key.begin(), key.end(), 0);
+                    std::shuffle(key.begin(), key.end(), rng);
+                } else {
+                    std::lock_guard<std::mutex> lock(best_mutex);
+                    key = best_key;
+                }
+                double score = anneal(ngrams, key, indices, rng);
+
+                std::lock_guard<std::mutex> lock(best_mutex);
+                if (score > best_score) {
+                    best_score = score;
+                    best_key = key;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 1; t < threads_; ++t) {
+            workers.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto& thread : workers) {
+            thread.join();
+        }
+
+        SubstitutionSolverResult result;
+        result.key.resize(26);
+        for (int i = 0; i < 26; ++i) {
+            result.key[i] = static_cast<char>('a' + best_key[i]);
+        }
+        result.plaintext = apply(ciphertext, result.key);
+        result.score = best_score;
+        result.restarts = config_.restarts;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+private:
+    /**
+     * @brief N-gramas distintos del texto cifrado, sus apariciones y las listas por letra.
+     */
+    struct Ngrams {
+        int order = 0;
+        std::vector<uint8_t> letters;          // order letras cifradas por n-grama
+        std::vector<uint32_t> count;           // apariciones de cada n-grama
+        std::vector<uint32_t> letterMask;      // bit i activo si contiene la letra cifrada i
+        std::array<std::vector<uint32_t>, 26> byLetter;
+        uint64_t total = 0;
+    };
+
+    Ngrams
+    collectNgrams(const std::string& ciphertext) const {
+        Ngrams ngrams;
+        ngrams.order = model_.order();
+        std::vector<uint8_t> letters;
+        for (unsigned char c : ciphertext) {
+            int letter = NGramModel::letterIndex(c);
+            if (letter >= 0) {
+                letters.push_back(static_cast<uint8_t>(letter));
+            }
+        }
+
+        std::unordered_map<uint32_t, uint32_t> slot_of;
+        for (size_t i = 0; i + ngrams.order <= letters.size(); ++i) {
+            uint32_t index = 0;
+            for (int k = 0; k < ngrams.order; ++k) {
+                index = index * 26 + letters[i + k];
+            }
+            auto inserted = slot_of.emplace(index, static_cast<uint32_t>(ngrams.count.size()));
+            if (inserted.second) {
+                uint32_t mask = 0;
+                for (int k = 0; k < ngrams.order; ++k) {
+                    ngrams.letters.push_back(letters[i + k]);
+                    mask |= 1u << letters[i + k];
+                }
+                ngrams.count.push_back(0);
+                ngrams.letterMask.push_back(mask);
+            }
+            ++ngrams.count[inserted.first->second];
+            ++ngrams.total;
+        }
+        for (uint32_t slot = 0; slot < ngrams.count.size(); ++slot) {
+            for (int letter = 0; letter < 26; ++letter) {
+                if (ngrams.letterMask[slot] & (1u << letter)) {
+                    ngrams.byLetter[letter].push_back(slot);
+                }
+            }
+        }
+        return ngrams;
+    }
+
+    static uint32_t
+    plainIndex(const Ngrams& ngrams, uint32_t slot, const Key& key) {
+        const uint8_t* letters = &ngrams.letters[slot * ngrams.order];
+        uint32_t index = 0;
+        for (int k = 0; k < ngrams.order; ++k) {
+            index = index * 26 + key[letters[k]];
+        }
+        return index;
+    }
+
+    double
+    fullScore(const Ngrams& ngrams, const Key& key) const {
+        double score = 0.0;
+        for (uint32_t slot = 0; slot < ngrams.count.size(); ++slot) {
+            score += ngrams.count[slot] * static_cast<double>(model_.ngram(plainIndex(ngrams, slot, key)));
+        }
+        return score;
+    }
+
+    /**
+     * @brief Cambio de aptitud al intercambiar key[a] y key[b], recorriendo solo los n-gramas afectados.
+     * 'indices' guarda el índice plano actual de cada n-grama; los nuevos quedan en 'pending' y
+     * commitSwap() los aplica si el cambio se acepta.
+     */
+    double
+    swapDelta(const Ngrams& ngrams, const Key& swapped, int a, int b, const std::vector<uint32_t>& indices,
+              std::vector<uint32_t>& pending) const {
+        double delta = 0.0;
+        pending.clear();
+        auto visit = [&](uint32_t slot) {
+            uint32_t updated = plainIndex(ngrams, slot, swapped);
+            delta += ngrams.count[slot] *
+                (static_cast<double>(model_.ngram(updated)) - static_cast<double>(model_.ngram(indices[slot])));
+            pending.push_back(updated);
+        };
+        for (uint32_t slot : ngrams.byLetter[a]) {
+            visit(slot);
+        }
+        for (uint32_t slot : ngrams.byLetter[b]) {
+            // Los que contienen ambas letras ya se contaron en la lista de 'a'.
+            if ((ngrams.letterMask[slot] & (1u << a)) == 0) {
+                visit(slot);
+            }
+        }
+        return delta;
+    }
+
+    static void
+    commitSwap(const Ngrams& ngrams, int a, int b, std::vector<uint32_t>& indices,
+               const std::vector<uint32_t>& pending) {
+        size_t next = 0;
+        for (uint32_t slot : ngrams.byLetter[a]) {
+            indices[slot] = pending[next++];
+        }
+        for (uint32_t slot : ngrams.byLetter[b]) {
+            if ((ngrams.letterMask[slot] & (1u << a)) == 0) {
+                indices[slot] = pending[next++];
+            }
+        }
+    }
+
+    /**
+     * @brief Un recocido completo desde 'key'; deja en 'key' la mejor clave visitada y devuelve su aptitud.
+     * Las temperaturas se expresan por n-grama del texto, así que no dependen de su longitud.
+     */
+    double
+    anneal(const Ngrams& ngrams, Key& key, std::vector<uint32_t>& indices, std::mt19937_64& rng) const {
+        for (uint32_t slot = 0; slot < ngrams.count.size(); ++slot) {
+            indices[slot] = plainIndex(ngrams, slot, key);
+        }
+        double score = fullScore(ngrams, key);
+        Key best = key;
+        double best_score = score;
+
+        std::vector<uint32_t> pending;
+        std::uniform_int_distribution<int> letter_dist(0, 25);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        const double scale = static_cast<double>(ngrams.total);
+        const double cooling = std::pow(config_.finalTemperature / config_.initialTemperature,
+                                        1.0 / std::max(1u, config_.iterationsPerRestart));
+        double temperature = config_.initialTemperature * scale;
+
+        for (unsigned int iteration = 0; iteration < config_.iterationsPerRestart; ++iteration, temperature *= cooling) {
+            int a = letter_dist(rng);
+            int b = letter_dist(rng);
+            if (a == b) {
+                continue;
+            }
+            Key swapped = key;
+            std::swap(swapped[a], swapped[b]);
+            double delta = swapDelta(ngrams, swapped, a, b, indices, pending);
+            if (delta >= 0.0 || unit(rng) < std::exp(delta / temperature)) {
+                key = swapped;
+                score += delta;
+                commitSwap(ngrams, a, b, indices, pending);
+                if (score > best_score) {
+                    best_score = score;
+                    best = key;
+                }
+            }
+        }
+        key = best;
+        return best_score;
+    }
+
+    /**
+     * @brief Clave inicial que empareja las letras cifradas con las planas por orden de frecuencia.
+     */
+    static Key
+    frequencyKey(const std::string& ciphertext) {
+        static const char SPANISH_ORDER[] = "eaosrnidlctumpbgvyqhfzjxwk";
+        std::array<uint64_t, 26> counts{};
+        for (unsigned char c : ciphertext) {
+            int letter = NGramModel::letterIndex(c);
+            if (letter >= 0) {
+                ++counts[letter];
+            }
+        }
+        std::array<int, 26> order;
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int x, int y) { return counts[x] > counts[y]; });
+        Key key{};
+        for (int rank = 0; rank < 26; ++rank) {
+            key[order[rank]] = static_cast<uint8_t>(SPANISH_ORDER[rank] - 'a');
+        }
+        return key;
+    }
+
+    const NGramModel& model_;
+    SubstitutionSolverConfig config_;
+    unsigned int threads_;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "DES.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Triple DES en modo EDE (cifrar-descifrar-cifrar) con dos o tres claves.
+ * Las tres listas de subclaves se calculan una sola vez en el constructor, y las tres pasadas
+ * se encadenan sobre la ruta rápida de DES sin los pares FP/IP intermedios, que se anulan entre sí.
+ */
+class TripleDES {
+public:
+    /**
+     * @brief Crea un 3DES EDE2 (K1, K2, K1).
+     */
+    TripleDES(const std::bitset<64>& key1, const std::bitset<64>& key2) :
+        TripleDES(key1, key2, key1) {
+    }
+
+    /**
+     * @brief Crea un 3DES EDE3 (K1, K2, K3).
+     */
+    TripleDES(const std::bitset<64>& key1, const std::bitset<64>& key2, const std::bitset<64>& key3) :
+        schedule1_(DES::fastSchedule(key1.to_ullong())),
+        schedule2_(DES::fastSchedule(key2.to_ullong())),
+        schedule3_(DES::fastSchedule(key3.to_ullong())) {
+    }
+
+    ~TripleDES() = default;
+
+    /**
+     * @brief Codifica un bloque: E_K3(D_K2(E_K1(P))).
+     * @param plaintext El bloque de 64 bits de texto plano.
+     * @return El bloque de 64 bits de texto cifrado.
+     */
+    uint64_t
+    encodeBlock(uint64_t plaintext) const {
+        uint64_t block = DES::iPermutationFast(plaintext);
+        block = DES::feistelRounds(block, schedule1_, false);
+        block = DES::feistelRounds(block, schedule2_, true);
+        block = DES::feistelRounds(block, schedule3_, false);
+        return DES::fPermutationFast(block);
+    }
+
+    /**
+     * @brief Decodifica un bloque: D_K1(E_K2(D_K3(C))).
+     * @param ciphertext El bloque de 64 bits de texto cifrado.
+     * @return El bloque de 64 bits de texto plano.
+     */
+    uint64_t
+    decodeBlock(uint64_t ciphertext) const {
+        uint64_t block = DES::iPermutationFast(ciphertext);
+        block = DES::feistelRounds(block, schedule3_, true);
+        block = DES::feistelRounds(block, schedule2_, false);
+        block = DES::feistelRounds(block, schedule1_, true);
+        return DES::fPermutationFast(block);
+    }
+
+    /**
+     * @brief Codifica un bloque en formato bitset, igual que DES::encode().
+     */
+    std::bitset<64>
+    encode(const std::bitset<64>& plaintext) const {
+        return std::bitset<64>(encodeBlock(plaintext.to_ullong()));
+    }
+
+    /**
+     * @brief Decodifica un bloque en formato bitset, igual que DES::decode().
+     */
+    std::bitset<64>
+    decode(const std::bitset<64>& ciphertext) const {
+        return std::bitset<64>(decodeBlock(ciphertext.to_ullong()));
+    }
+
+private:
+    DES::FastSchedule schedule1_;
+    DES::FastSchedule schedule2_;
+    DES::FastSchedule schedule3_;
+};
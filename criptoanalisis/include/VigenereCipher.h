@@ -0,0 +1,349 @@
+#pragma once
+#include "CesarKernel.h"
+#include "LetterFrequency.h"
+#include "NGramModel.h"
+#include "Prerequisites.h"
+
+/**
+ * @brief Puntuación de una longitud de clave candidata.
+ */
+struct VigenereKeyLength {
+    int length = 0;
+    double indexOfCoincidence = 0.0;
+    uint64_t kasiskiVotes = 0;
+};
+
+/**
+ * @brief Resultado del criptoanálisis de un texto cifrado con Vigenère.
+ */
+struct VigenereCrackResult {
+    std::string key;
+    std::string plaintext;
+    double score = 0.0;
+    double seconds = 0.0;
+    std::vector<VigenereKeyLength> keyLengths;
+};
+
+/**
+ * @brief Cifrado de Vigenère sobre las letras A-Z/a-z (se conservan mayúsculas y minúsculas).
+ * Los caracteres que no son letras se copian sin consumir posición de la clave.
+ * El cifrado usa como tabla de Vigenère las tablas de traducción de CesarKernel; los bloques de
+ * 16 bytes formados solo por letras se transforman con SSE2 sumando el tramo de la clave.
+ */
+class VigenereCipher {
+public:
+    VigenereCipher(unsigned int threads = 0) :
+        threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    }
+
+    ~VigenereCipher() = default;
+
+    /**
+     * @brief Cifra un texto con Vigenère.
+     * @param texto El texto plano.
+     * @param clave La clave (solo se usan sus letras).
+     * @return El texto cifrado.
+     */
+    std::string
+    encode(const std::string& texto, const std::string& clave) const {
+        std::string result(texto.size(), '\0');
+        transform(texto.data(), texto.size(), &result[0], keyShifts(clave, false));
+        return result;
+    }
+
+    /**
+     * @brief Descifra un texto cifrado con Vigenère.
+     * @param texto El texto cifrado.
+     * @param clave La clave usada para cifrar.
+     * @return El texto plano.
+     */
+    std::string
+    decode(const std::string& texto, const std::string& clave) const {
+        std::string result(texto.size(), '\0');
+        transform(texto.data(), texto.size(), &result[0], keyShifts(clave, true));
+        return result;
+    }
+
+    /**
+     * @brief Aplica una secuencia de desplazamientos (uno por letra, en ciclo) escribiendo en el búfer del llamador.
+     * @param src Texto de entrada.
+     * @param length Longitud en bytes.
+     * @param dst Búfer de salida de al menos 'length' bytes.
+     * @param shifts Desplazamientos 0-25 de cada posición de la clave.
+     */
+    static void
+    transform(const char* src, size_t length, char* dst, const std::vector<uint8_t>& shifts) {
+        const size_t period = shifts.size();
+        // La clave repetida con 16 posiciones extra permite cargar cualquier tramo de 16 desplazamientos.
+        std::vector<uint8_t> stream(period + 16);
+        for (size_t i = 0; i < stream.size(); ++i) {
+            stream[i] = shifts[i % period];
+        }
+
+        size_t position = 0;
+        size_t i = 0;
+#if CESAR_KERNEL_SSE2
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i letter_a = _mm_set1_epi8('a');
+        const __m128i last_letter = _mm_set1_epi8(25);
+        const __m128i alphabet = _mm_set1_epi8(26);
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i t = _mm_sub_epi8(_mm_or_si128(block, case_bit), letter_a);
+            __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(t, last_letter), t);
+            if (_mm_movemask_epi8(is_letter) != 0xFFFF) {
+                // Bloque con separadores: la posición de la clave avanza de forma irregular.
+                position = transformScalar(src + i, 16, dst + i, shifts, position);
+                continue;
+            }
+            __m128i shift = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stream.data() + position));
+            __m128i sum = _mm_add_epi8(t, shift);
+            __m128i wraps = _mm_cmpeq_epi8(_mm_max_epu8(sum, alphabet), sum);
+            __m128i delta = _mm_sub_epi8(shift, _mm_and_si128(wraps, alphabet));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi8(block, delta));
+            position = (position + 16) % period;
+        }
+#endif
+        transformScalar(src + i, length - i, dst + i, shifts, position);
+    }
+
+    /**
+     * @brief Desplazamientos de una clave; para descifrar se usan los inversos.
+     * @throws std::invalid_argument Si la clave no contiene letras.
+     */
+    static std::vector<uint8_t>
+    keyShifts(const std::string& clave, bool inverse) {
+        std::vector<uint8_t> shifts;
+        for (unsigned char c : clave) {
+            int letter = NGramModel::letterIndex(c);
+            if (letter >= 0) {
+                shifts.push_back(static_cast<uint8_t>(inverse ? (26 - letter) % 26 : letter));
+            }
+        }
+        if (shifts.empty()) {
+            throw std::invalid_argument("La clave de Vigenere debe contener al menos una letra.");
+        }
+        return shifts;
+    }
+
+    /**
+     * @brief Índice de coincidencia medio de las columnas al repartir las letras en 'length' columnas.
+     * @param letters Letras del texto como índices 0-25.
+     * @param length Longitud de clave supuesta.
+     */
+    static double
+    indexOfCoincidence(const std::vector<uint8_t>& letters, int length) {
+        double total = 0.0;
+        int columns = 0;
+        for (int column = 0; column < length; ++column) {
+            LetterFrequency::Histogram counts = columnHistogram(letters, length, column);
+            uint64_t n = 0;
+            uint64_t pairs = 0;
+            for (uint64_t count : counts) {
+                n += count;
+                if (count > 1) {
+                    pairs += count * (count - 1);
+                }
+            }
+            if (n > 1) {
+                total += static_cast<double>(pairs) / static_cast<double>(n * (n - 1));
+                ++columns;
+            }
+        }
+        return columns > 0 ? total / columns : 0.0;
+    }
+
+    /**
+     * @brief Método de Kasiski: cada distancia entre trigramas repetidos vota por sus divisores.
+     * @param letters Letras del texto como índices 0-25.
+     * @param maxLength Longitud de clave máxima considerada.
+     * @return Votos de cada longitud (índice = longitud).
+     */
+    static std::vector<uint64_t>
+    kasiskiVotes(const std::vector<uint8_t>& letters, int maxLength) {
+        std::vector<uint64_t> votes(maxLength + 1, 0);
+        // Última aparición de cada trigrama (26^3 entradas), en una sola pasada.
+        std::vector<int64_t> last(26 * 26 * 26, -1);
+        for (size_t i = 0; i + 2 < letters.size(); ++i) {
+            size_t trigram = (letters[i] * 26 + letters[i + 1]) * 26 + letters[i + 2];
+            if (last[trigram] >= 0) {
+                uint64_t distance = i - static_cast<size_t>(last[trigram]);
+                for (int length = 2; length <= maxLength; ++length) {
+                    if (distance % length == 0) {
+                        ++votes[length];
+                    }
+                }
+            }
+            last[trigram] = static_cast<int64_t>(i);
+        }
+        return votes;
+    }
+
+    /**
+     * @brief Recupera la clave y el texto plano de un cifrado de Vigenère.
+     * Las longitudes candidatas se ordenan por índice de coincidencia y votos de Kasiski; las mejores
+     * se resuelven en paralelo (cada columna es un César que se puntúa rotando su histograma) y gana
+     * la de mayor verosimilitud, usando el modelo de n-gramas compartido si existe.
+     * @param texto El texto cifrado.
+     * @param maxKeyLength Longitud de clave máxima a considerar.
+     * @return La clave encontrada, el texto plano y la puntuación de cada longitud.
+     */
+    VigenereCrackResult
+    crack(const std::string& texto, int maxKeyLength = 20) const {
+        auto start_time = std::chrono::steady_clock::now();
+        VigenereCrackResult result;
+
+        std::vector<uint8_t> letters;
+        letters.reserve(texto.size());
+        for (unsigned char c : texto) {
+            int letter = NGramModel::letterIndex(c);
+            if (letter >= 0) {
+                letters.push_back(static_cast<uint8_t>(letter));
+            }
+        }
+        if (letters.size() < 2) {
+            throw std::invalid_argument("El texto cifrado no contiene suficientes letras.");
+        }
+        maxKeyLength = std::max(1, std::min<int>(maxKeyLength, static_cast<int>(letters.size() / 2)));
+
+        // Índice de coincidencia de cada longitud, calculado en paralelo.
+        std::vector<VigenereKeyLength> lengths(maxKeyLength);
+        std::vector<uint64_t> votes = kasiskiVotes(letters, maxKeyLength);
+        parallelFor(maxKeyLength, [&](size_t index) {
+            int length = static_cast<int>(index) + 1;
+            lengths[index] = {length, indexOfCoincidence(letters, length), votes[length]};
+        });
+
+        // Los múltiplos de la longitud real tienen el mismo índice; se prueban las longitudes que
+        // se acercan al mejor índice y las más votadas por Kasiski.
+        double best_ioc = 0.0;
+        uint64_t best_votes = 0;
+        for (const auto& candidate : lengths) {
+            best_ioc = std::max(best_ioc, candidate.indexOfCoincidence);
+            best_votes = std::max(best_votes, candidate.kasiskiVotes);
+        }
+        std::vector<int> trial_lengths;
+        for (const auto& candidate : lengths) {
+            bool ioc_close = candidate.indexOfCoincidence >= IOC_CANDIDATE_RATIO * best_ioc;
+            bool kasiski_strong = best_votes > 0 && candidate.kasiskiVotes * 4 >= best_votes * 3;
+            if (ioc_close || kasiski_strong) {
+                trial_lengths.push_back(candidate.length);
+            }
+        }
+
+        auto model = NGramModel::shared();
+        std::vector<std::string> keys(trial_lengths.size());
+        std::vector<double> scores(trial_lengths.size());
+        parallelFor(trial_lengths.size(), [&](size_t index) {
+            int length = trial_lengths[index];
+            std::string key(length, 'a');
+            std::vector<uint8_t> plain(letters.size());
+            for (int column = 0; column < length; ++column) {
+                int shift = LetterFrequency::bestShift(columnHistogram(letters, length, column));
+                key[column] = static_cast<char>('a' + shift);
+                for (size_t i = column; i < letters.size(); i += length) {
+                    plain[i] = static_cast<uint8_t>((letters[i] + 26 - shift) % 26);
+                }
+            }
+            keys[index] = key;
+            scores[index] = model ? model->scoreIndices(plain.data(), plain.size()) * LN_10
+                                  : letterLogLikelihood(plain);
+        });
+
+        size_t best = 0;
+        for (size_t i = 1; i < trial_lengths.size(); ++i) {
+            // Con la misma puntuación gana la clave más corta (las largas repiten a la corta).
+            if (scores[i] > scores[best] + 1e-9) {
+                best = i;
+            }
+        }
+
+        result.key = shortestPeriod(keys[best]);
+        result.plaintext = decode(texto, result.key);
+        result.score = scores[best];
+        result.keyLengths = std::move(lengths);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+private:
+    // Fracción del mejor índice de coincidencia a partir de la cual se prueba una longitud.
+    static constexpr double IOC_CANDIDATE_RATIO = 0.9;
+    static constexpr double LN_10 = 2.302585092994046;
+
+    static size_t
+    transformScalar(const char* src, size_t length, char* dst, const std::vector<uint8_t>& shifts, size_t position) {
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(src[i]);
+            if (NGramModel::letterIndex(c) >= 0) {
+                dst[i] = static_cast<char>(CesarKernel::letterTable(shifts[position])[c]);
+                if (++position == shifts.size()) {
+                    position = 0;
+                }
+            } else {
+                dst[i] = static_cast<char>(c);
+            }
+        }
+        return position;
+    }
+
+    static LetterFrequency::Histogram
+    columnHistogram(const std::vector<uint8_t>& letters, int length, int column) {
+        LetterFrequency::Histogram counts{};
+        for (size_t i = column; i < letters.size(); i += length) {
+            ++counts[letters[i]];
+        }
+        return counts;
+    }
+
+    static double
+    letterLogLikelihood(const std::vector<uint8_t>& plain) {
+        LetterFrequency::Histogram counts{};
+        for (uint8_t letter : plain) {
+            ++counts[letter];
+        }
+        return LetterFrequency::scoreShift(counts, 0);
+    }
+
+    /**
+     * @brief Reduce una clave que es repetición de otra más corta ("abcabc" -> "abc").
+     */
+    static std::string
+    shortestPeriod(const std::string& key) {
+        for (size_t period = 1; period < key.size(); ++period) {
+            if (key.size() % period != 0) {
+                continue;
+            }
+            bool repeats = true;
+            for (size_t i = period; i < key.size() && repeats; ++i) {
+                repeats = key[i] == key[i - period];
+            }
+            if (repeats) {
+                return key.substr(0, period);
+            }
+        }
+        return key;
+    }
+
+    template<typename Task>
+    void
+    parallelFor(size_t count, Task task) const {
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t index = next.fetch_add(1); index < count; index = next.fetch_add(1)) {
+                task(index);
+            }
+        };
+        std::vector<std::thread> workers;
+        unsigned int helpers = static_cast<unsigned int>(std::min<size_t>(threads_, count));
+        for (unsigned int t = 1; t < helpers; ++t) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+
+    unsigned int threads_;
+};
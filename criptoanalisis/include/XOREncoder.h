@@ -1,4 +1,5 @@
 #pragma once
+#include "NGramModel.h"
 #include "Prerequisites.h"
 
 class XOREncoder {
@@ -80,7 +81,8 @@ public:
     }
 
     /**
-     * @brief Realiza fuerza bruta con claves de 1 byte e imprime resultados válidos.
+     * @brief Realiza fuerza bruta con claves de 1 byte e imprime resultados válidos
+     * (ordenados por el modelo de n-gramas si hay uno entrenado).
      * @param cifrado Vector de bytes del texto cifrado.
      */
     void
@@ -90,7 +92,7 @@ public:
             std::cout << "  Texto cifrado vacío, no se puede realizar fuerza bruta de 1 byte." << std::endl;
             return;
         }
-        int valid_count = 0;
+        std::vector<Candidate> candidates;
         for (int clave_byte = 0; clave_byte < 256; ++clave_byte) {
             std::string result_text;
             result_text.reserve(cifrado.size());
@@ -99,21 +101,18 @@ public:
             }
 
             if (isValidText(result_text)) {
-                valid_count++;
-                std::cout << "=============================\n";
-                std::cout << "Clave Byte  : 0x" << std::hex << std::setw(2) << std::setfill('0') << clave_byte
-                    << " ('" << (std::isprint(clave_byte) ? static_cast<char>(clave_byte) : '.') << "')\n";
-                std::cout << "Texto posible : " << result_text << "\n";
+                std::ostringstream label;
+                label << "Clave Byte  : 0x" << std::hex << std::setw(2) << std::setfill('0') << clave_byte
+                    << " ('" << (std::isprint(clave_byte) ? static_cast<char>(clave_byte) : '.') << "')";
+                candidates.push_back({label.str(), std::move(result_text)});
             }
         }
-        if (valid_count == 0) {
-            std::cout << "  No se encontraron textos legibles con claves de 1 byte." << std::endl;
-        }
-        std::cout << std::dec;
+        printCandidates(candidates, "  No se encontraron textos legibles con claves de 1 byte.");
     }
 
     /**
-     * @brief Realiza fuerza bruta con claves de 2 bytes e imprime resultados válidos.
+     * @brief Realiza fuerza bruta con claves de 2 bytes e imprime resultados válidos
+     * (con modelo de n-gramas, solo los más probables).
      * @param cifrado Vector de bytes del texto cifrado.
      */
     void
@@ -123,7 +122,7 @@ public:
             std::cout << "  Texto cifrado vacío, no se puede realizar fuerza bruta de 2 bytes." << std::endl;
             return;
         }
-        int valid_count = 0;
+        std::vector<Candidate> candidates;
         for (int b1 = 0; b1 < 256; ++b1) {
             for (int b2 = 0; b2 < 256; ++b2) {
                 std::string result_text;
@@ -134,20 +133,16 @@ public:
                 }
 
                 if (isValidText(result_text)) {
-                    valid_count++;
-                    std::cout << "=============================\n";
-                    std::cout << "Clave 2 bytes : 0x" << std::hex << std::setw(2) << std::setfill('0') << b1
+                    std::ostringstream label;
+                    label << "Clave 2 bytes : 0x" << std::hex << std::setw(2) << std::setfill('0') << b1
                         << " 0x" << std::setw(2) << std::setfill('0') << b2
                         << " ('" << (std::isprint(b1) ? static_cast<char>(b1) : '.')
-                        << (std::isprint(b2) ? static_cast<char>(b2) : '.') << "')\n";
-                    std::cout << "Texto posible : " << result_text << "\n";
+                        << (std::isprint(b2) ? static_cast<char>(b2) : '.') << "')";
+                    candidates.push_back({label.str(), std::move(result_text)});
                 }
             }
         }
-        if (valid_count == 0) {
-            std::cout << "  No se encontraron textos legibles con claves de 2 bytes." << std::endl;
-        }
-        std::cout << std::dec;
+        printCandidates(candidates, "  No se encontraron textos legibles con claves de 2 bytes.");
     }
 
     /**
@@ -187,7 +182,7 @@ public:
 
     /**
      * @brief Realiza fuerza bruta usando una lista de claves comunes cargadas desde un archivo.
-     * Imprime los resultados válidos localmente.
+     * Imprime los resultados válidos localmente, ordenados por el modelo de n-gramas si hay uno.
      * @param cifrado Vector de bytes del texto cifrado.
      */
     void
@@ -206,7 +201,7 @@ public:
                 << std::endl;
             return;
         }
-        int valid_count = 0;
+        std::vector<Candidate> candidates;
         for (const auto& clave_str : clavesComunes) {
             if (clave_str.empty())
                 continue;
@@ -217,18 +212,76 @@ public:
             }
 
             if (isValidText(result_text)) {
-                valid_count++;
-                std::cout << "=============================\n";
-                std::cout << "Clave de diccionario: '" << clave_str << "'\n";
-                std::cout << "Texto posible : " << result_text << "\n";
+                candidates.push_back({"Clave de diccionario: '" + clave_str + "'", std::move(result_text)});
             }
         }
-        if (valid_count == 0) {
-            std::cout << "  No se encontraron textos legibles con las claves del diccionario proporcionado." <<
-                std::endl;
-        }
+        printCandidates(candidates,
+                        "  No se encontraron textos legibles con las claves del diccionario proporcionado.");
     }
 
 private:
+    // Textos legibles que se muestran cuando el modelo de n-gramas permite ordenarlos.
+    static constexpr size_t MAX_RANKED_CANDIDATES = 10;
+    // Log10-probabilidad con la que se penaliza cada byte que no es letra ni espacio.
+    static constexpr double NON_LETTER_LOG10 = -6.0;
+    // Desempate a favor de las minúsculas: las claves que solo invierten mayúsculas/minúsculas
+    // dan la misma puntuación de n-gramas que la correcta.
+    static constexpr double LOWERCASE_BONUS = 1e-3;
+
+    /**
+     * @brief Texto legible obtenido con una clave, con la descripción de esta ya formateada.
+     */
+    struct Candidate {
+        std::string keyLabel;
+        std::string text;
+        double score = 0.0;
+    };
+
+    /**
+     * @brief Log10-verosimilitud media por byte de un texto según el modelo de n-gramas,
+     * penalizando los bytes que no son letras ni espacios.
+     */
+    static double
+    languageScore(const NGramModel& model, const std::string& text) {
+        double total = model.score(text);
+        for (unsigned char c : text) {
+            if (std::islower(c)) {
+                total += LOWERCASE_BONUS;
+            } else if (!std::isalpha(c) && c != ' ') {
+                total += NON_LETTER_LOG10;
+            }
+        }
+        return total / static_cast<double>(text.size());
+    }
+
+    /**
+     * @brief Imprime los textos legibles. Con el modelo de n-gramas compartido se ordenan de más
+     * a menos probable y solo se muestran los MAX_RANKED_CANDIDATES primeros.
+     */
+    static void
+    printCandidates(std::vector<Candidate>& candidates, const char* none_message) {
+        if (candidates.empty()) {
+            std::cout << none_message << std::endl;
+            return;
+        }
+        size_t shown = candidates.size();
+        if (auto model = NGramModel::shared()) {
+            for (auto& candidate : candidates) {
+                candidate.score = languageScore(*model, candidate.text);
+            }
+            std::stable_sort(candidates.begin(), candidates.end(),
+                             [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+            shown = std::min(shown, MAX_RANKED_CANDIDATES);
+            std::cout << "  " << candidates.size() << " textos legibles; se muestran los " << shown
+                << " más probables según el modelo de n-gramas." << std::endl;
+        }
+        for (size_t i = 0; i < shown; ++i) {
+            std::cout << "=============================\n";
+            std::cout << candidates[i].keyLabel << "\n";
+            std::cout << "Texto posible : " << candidates[i].text << "\n";
+        }
+        std::cout << std::flush;
+    }
+
     std::string dict_filepath_;
 };
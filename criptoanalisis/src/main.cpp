@@ -1,7 +1,21 @@
 #include "Prerequisites.h"
 #include "AsciiBinary.h"
+#include "BlockCipherModes.h"
+#include "CesarBatchCracker.h"
 #include "CesarEncryption.h"
 #include "DES.h"
+#include "DESDifferential.h"
+#include "DESKeySearch.h"
+#include "DESLinear.h"
+#include "DESRainbowTable.h"
+#include "DoubleDESMeetInTheMiddle.h"
+#include "MonoalphabeticFamilies.h"
+#include "NGramModel.h"
+#include "ScoreCache.h"
+#include "ScoringPipeline.h"
+#include "SubstitutionSolver.h"
+#include "TripleDES.h"
+#include "VigenereCipher.h"
 #include "XOREncoder.h"
 
 void
@@ -121,13 +135,530 @@ useDes() {
 	//auto ciphertext = des.encode(plaintext);
 }
 
+void
+useDesKeySearch() {
+    std::cout << "--- DEMOSTRACIÓN DE DESKeySearch ---" << std::endl;
+
+    uint64_t secret_key = 0x133457799BBCDFF1ULL;
+    DES des(std::bitset<64>{secret_key});
+
+    std::vector<DESKnownPair> pairs;
+    for (const char* block : {"$Hola DE", "S! 12345"}) {
+        uint64_t plaintext = des.stringToBitset64(block).to_ullong();
+        pairs.push_back({plaintext, des.encodeBlock(plaintext)});
+    }
+
+    // Se conocen todos los bits de la clave excepto 24.
+    DESKeySpace space = DESKeySpace::fromBitRange(secret_key, 16, 40);
+    std::cout << "Claves a probar: " << space.size() << std::endl;
+
+    DESKeySearch search;
+    DESKeySearchResult result = search.search(pairs, space);
+    if (result.found) {
+        std::cout << "Clave encontrada: " << std::hex << std::uppercase << std::setw(16) << std::setfill('0')
+            << result.key << std::dec << std::endl;
+    } else {
+        std::cout << "No se encontró la clave en el espacio indicado." << std::endl;
+    }
+    std::cout << "Claves probadas: " << result.keysTested << " en " << result.seconds << " s" << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useTripleDes() {
+    std::cout << "--- DEMOSTRACIÓN DE TripleDES (EDE3, modo CBC) ---" << std::endl;
+
+    TripleDES triple_des(std::bitset<64>{0x0123456789ABCDEFULL},
+                         std::bitset<64>{0x23456789ABCDEF01ULL},
+                         std::bitset<64>{0x456789ABCDEF0123ULL});
+    uint64_t iv = 0x0F1E2D3C4B5A6978ULL;
+
+    std::string phrase = "Mensaje de prueba para 3DES en modo CBC";
+    std::string ciphertext = encryptWithMode(triple_des, BlockMode::CBC, phrase, iv);
+
+    std::cout << "Texto original: " << phrase << std::endl;
+    std::cout << "Cifrado en hexadecimal: ";
+    for (unsigned char c : ciphertext) {
+        std::cout << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+    }
+    std::cout << std::dec << std::endl;
+    std::cout << "Texto descifrado: " << decryptWithMode(triple_des, BlockMode::CBC, ciphertext, iv) << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useDoubleDesMeetInTheMiddle() {
+    std::cout << "--- DEMOSTRACIÓN DE DoubleDESMeetInTheMiddle ---" << std::endl;
+
+    uint64_t key1 = 0x133457799BBCDFF1ULL;
+    uint64_t key2 = 0x0E329232EA6D0D73ULL;
+    DES first(std::bitset<64>{key1});
+    DES second(std::bitset<64>{key2});
+
+    std::vector<DESKnownPair> pairs;
+    for (uint64_t plaintext : {0x0123456789ABCDEFULL, 0x1122334455667788ULL}) {
+        pairs.push_back({plaintext, second.encodeBlock(first.encodeBlock(plaintext))});
+    }
+
+    // Doble DES con 20 bits desconocidos en cada clave: 2^21 cifrados en lugar de 2^40.
+    MeetInTheMiddleConfig config;
+    config.memoryBudgetBytes = size_t(64) << 20;
+    DoubleDESMeetInTheMiddle attack(config);
+    MeetInTheMiddleResult result = attack.attack(pairs, DESKeySpace::fromBitRange(key1, 8, 28),
+                                                 DESKeySpace::fromBitRange(key2, 20, 40));
+
+    std::cout << "Entradas en la tabla: " << result.tableEntries
+        << (result.spilledToDisk ? " (en disco)" : " (en memoria)") << std::endl;
+    for (const auto& keys : result.keys) {
+        std::cout << "Claves encontradas: K1=" << std::hex << std::uppercase << std::setw(16) << std::setfill('0')
+            << keys.key1 << " K2=" << std::setw(16) << keys.key2 << std::dec << std::endl;
+    }
+    std::cout << "Tabla: " << result.buildSeconds << " s, busqueda: " << result.searchSeconds << " s" << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useDesRainbowTable() {
+    std::cout << "--- DEMOSTRACIÓN DE DESRainbowTable ---" << std::endl;
+
+    // Claves derivadas de contraseñas de 6 letras minúsculas y un bloque de texto plano conocido.
+    DESKeySpace space = DESKeySpace::fromCharset("abcdefghijklmnopqrstuvwxyz", 6);
+    DES helper;
+    uint64_t plaintext = helper.stringToBitset64("$Hola DE").to_ullong();
+
+    std::string table_path = "des_rainbow.bin";
+    uint64_t chains = DESRainbowTable::generate(table_path, space, plaintext, 300, 8000);
+    std::cout << "Tabla generada con " << chains << " cadenas en '" << table_path << "'" << std::endl;
+
+    DESRainbowTable table;
+    table.open(table_path);
+
+    // Contraseñas al azar del mismo espacio: la tasa de acierto mide lo que cubre la tabla.
+    const int trials = 100;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint64_t> pick(0, space.size() - 1);
+    int found = 0;
+    uint64_t encryptions = 0;
+    double seconds = 0.0;
+    for (int i = 0; i < trials; ++i) {
+        DES des(std::bitset<64>{space.keyAt(pick(rng))});
+        RainbowLookupResult result = table.lookup(des.encodeBlock(plaintext));
+        if (result.found) {
+            if (found == 0) {
+                std::cout << "Primera clave equivalente encontrada: " << std::hex << std::uppercase << std::setw(16)
+                    << std::setfill('0') << result.key << std::dec << std::endl;
+            }
+            ++found;
+        }
+        encryptions += result.encryptions;
+        seconds += result.seconds;
+    }
+    std::cout << "Claves recuperadas: " << found << " de " << trials << std::endl;
+    std::cout << "Cifrados por busqueda (media): " << encryptions / trials << " (" << seconds * 1000.0 / trials
+        << " ms)" << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useDesDifferential() {
+    std::cout << "--- DEMOSTRACIÓN DE DESDifferential (3 rondas) ---" << std::endl;
+
+    DESDifferential differential;
+    auto ddt = DESDifferential::differenceDistributionTable();
+    std::cout << "DDT[0x20][*]:";
+    for (uint32_t count : ddt[0x20]) {
+        std::cout << " " << count;
+    }
+    std::cout << std::endl;
+
+    // Características de 2 rondas encontradas empíricamente y ataque a la última ronda de DES<3>.
+    // Cada una deja dos candidatas (k y k ^ Δentrada) en las cajas que activa; al combinar varias
+    // con diferencias de entrada distintas en una caja, esa caja queda resuelta.
+    uint64_t secret_key = 0x133457799BBCDFF1ULL;
+    uint64_t real_subkey = DES::fastSchedule(secret_key)[0];
+    const uint64_t input_differences[] = {0x6000000000000000ULL, 0x0060000000000000ULL, 0x0600000000000000ULL};
+    std::optional<DifferentialAttackResult> combined;
+    for (uint64_t input_difference : input_differences) {
+        DifferentialCharacteristic characteristic = differential.findCharacteristic<2>(input_difference, 200000);
+        DifferentialPairs pairs = differential.generatePairs<3>(secret_key, input_difference, 200000);
+        DifferentialAttackResult result = differential.attackLastRound(pairs, characteristic);
+        combined = combined ? DESDifferential::intersect(*combined, result) : result;
+        std::cout << "dP=" << std::hex << input_difference << ": dL=" << characteristic.leftDifference << " dR="
+            << characteristic.rightDifference << std::dec << " p=" << characteristic.probability
+            << ", pares filtrados " << result.pairsFiltered << ", cajas informativas "
+            << static_cast<int>(result.informativeBoxes) << "/8" << std::endl;
+    }
+
+    std::string unresolved;
+    for (int box = 0; box < 8; ++box) {
+        if (combined->recovered(box)) {
+            std::cout << "  Caja " << box << ": subclave " << static_cast<int>(combined->candidates[box].front())
+                << ", real " << ((real_subkey >> (box * 6)) & 0x3F) << std::endl;
+        } else {
+            unresolved += " " + std::to_string(box);
+        }
+    }
+    if (!unresolved.empty()) {
+        std::cout << "Cajas sin resolver:" << unresolved << " (hacen falta otras caracteristicas)" << std::endl;
+    }
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useDesLinear() {
+    std::cout << "--- DEMOSTRACIÓN DE DESLinear (2 rondas) ---" << std::endl;
+
+    auto lat = DESLinear::linearApproximationTable();
+    std::cout << "LAT[0x02][*]:";
+    for (int bias : lat[0x02]) {
+        std::cout << " " << bias;
+    }
+    std::cout << std::endl;
+
+    uint64_t secret_key = 0x133457799BBCDFF1ULL;
+    DESLinear linear;
+    LinearSamples samples = linear.generateSamples<2>(secret_key, size_t(1) << 20);
+
+    // Tras la primera ronda L1 = R0, así que α = βL sobre R0 es una aproximación exacta de 1 ronda.
+    uint64_t real_subkey = DES::fastSchedule(secret_key)[0];
+    for (int box = 0; box < 8; ++box) {
+        uint32_t left_mask = DESAnalysis::permuteP(0x5u << (box * 4));
+        LinearApproximation approximation{left_mask, left_mask, 0};
+        LinearAttackResult result = linear.attackLastRound(samples, approximation);
+        std::cout << "  Caja " << result.box << ": subclave " << static_cast<int>(result.bestGuess)
+            << " (real " << ((real_subkey >> (box * 6)) & 0x3F) << "), sesgo " << result.bestBias << std::endl;
+    }
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useNGramModel() {
+    std::cout << "--- DEMOSTRACIÓN DEL MODELO DE N-GRAMAS ---" << std::endl;
+
+    // Para un modelo útil, entrenar con un corpus grande:
+    //   criptoanalisis --entrenar-ngramas <corpus.txt> dictionaries/ngramasES.bin [orden]
+    // El modelo de esta demostración va a un archivo aparte para no sustituir al entrenado.
+    const std::string ruta_demo = "ngramas_demo.bin";
+    uint64_t ngrams = NGramModel::train("dictionaries/corpusES.txt", ruta_demo, 4);
+    std::cout << "Cuadrigramas contados en el corpus: " << ngrams << std::endl;
+
+    NGramModel model;
+    model.load(ruta_demo);
+
+    CesarEncryption cesar;
+    std::string cifrado = cesar.encode("El maestro reunia a los ninos bajo un arbol grande", 9);
+    std::vector<ShiftScore> candidates;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int key = 0; key < 26; ++key) {
+        candidates.push_back({key, model.score(cesar.decode(cifrado, key))});
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::sort(candidates.begin(), candidates.end());
+
+    std::cout << "Mejores claves para \"" << cifrado << "\":" << std::endl;
+    for (size_t i = 0; i < 3; ++i) {
+        std::cout << "  Clave " << candidates[i].key << " (log10 p = " << candidates[i].score << "): "
+            << cesar.decode(cifrado, candidates[i].key) << std::endl;
+    }
+    std::cout << "26 candidatos puntuados en "
+        << std::chrono::duration<double, std::micro>(end - start).count() << " us" << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useVigenere() {
+    std::cout << "--- DEMOSTRACIÓN DE VIGENÈRE ---" << std::endl;
+
+    std::ifstream corpus("dictionaries/corpusES.txt");
+    std::string texto((std::istreambuf_iterator<char>(corpus)), std::istreambuf_iterator<char>());
+    if (texto.empty()) {
+        texto = "El analisis de frecuencias es una de las tecnicas mas antiguas del criptoanalisis y permite "
+            "descubrir la clave de un cifrado por sustitucion cuando el mensaje es suficientemente largo";
+    }
+
+    VigenereCipher vigenere;
+    std::string cifrado = vigenere.encode(texto, "criptografia");
+    std::cout << "Cifrado: " << cifrado.substr(0, 80) << "..." << std::endl;
+
+    VigenereCrackResult result = vigenere.crack(cifrado);
+    std::cout << "Longitudes de clave (indice de coincidencia / votos de Kasiski):" << std::endl;
+    for (const auto& length : result.keyLengths) {
+        std::cout << "  " << length.length << ": " << length.indexOfCoincidence << " / " << length.kasiskiVotes
+            << std::endl;
+    }
+    std::cout << "Clave encontrada: " << result.key << " (" << result.seconds * 1000.0 << " ms)" << std::endl;
+    std::cout << "Texto: " << result.plaintext.substr(0, 80) << "..." << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useSubstitution() {
+    std::cout << "--- DEMOSTRACIÓN DEL SOLUCIONADOR DE SUSTITUCIÓN ---" << std::endl;
+
+    // Con un corpus pequeño los trigramas generalizan mejor que los cuadrigramas.
+    NGramModel::train("dictionaries/corpusES.txt", "dictionaries/trigramasES.bin", 3);
+    NGramModel model;
+    model.load("dictionaries/trigramasES.bin");
+
+    std::string texto = "Los modelos de lenguaje basados en grupos de letras consecutivas son todavia mas precisos. "
+        "En lugar de observar cada letra por separado, estudian con que probabilidad aparece una secuencia de dos, "
+        "tres o cuatro letras. Asi, un texto que contiene combinaciones frecuentes recibe una puntuacion alta, "
+        "mientras que un texto con combinaciones imposibles en espanol obtiene una puntuacion muy baja. Gracias a "
+        "ello es posible distinguir el texto correcto entre miles de candidatos en muy poco tiempo.";
+    std::string clave = "qwertyuiopasdfghjklzxcvbnm";
+    std::string cifrado = SubstitutionSolver::apply(texto, clave);
+    std::cout << "Cifrado: " << cifrado.substr(0, 80) << "..." << std::endl;
+
+    SubstitutionSolver solver(model);
+    SubstitutionSolverResult result = solver.solve(cifrado);
+    std::cout << "Clave de descifrado: " << result.key << " (real " << SubstitutionSolver::invert(clave) << ")"
+        << std::endl;
+    std::cout << "Reinicios: " << result.restarts << ", tiempo: " << result.seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Texto: " << result.plaintext.substr(0, 80) << "..." << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useMonoalphabeticFamilies() {
+    std::cout << "--- DEMOSTRACIÓN DE FAMILIAS MONOALFABÉTICAS ---" << std::endl;
+
+    std::string texto = "El analisis de frecuencias es una de las tecnicas mas antiguas del criptoanalisis.";
+    std::vector<std::pair<std::string, std::string>> cifrados = {
+        {"Afin (7, 3)", MonoalphabeticFamilies::affineEncode(texto, 7, 3)},
+        {"Atbash", MonoalphabeticFamilies::atbash(texto)},
+        {"ROT47", MonoalphabeticFamilies::rot47(texto)},
+    };
+    for (const auto& cifrado : cifrados) {
+        std::cout << "\n" << cifrado.first << ": " << cifrado.second << std::endl;
+        for (const auto& candidate : MonoalphabeticFamilies::crack(cifrado.second, 3)) {
+            std::cout << "  " << candidate.family << " (a=" << candidate.a << ", b=" << candidate.b
+                << ") score " << candidate.score << ": " << candidate.plaintext.substr(0, 50) << std::endl;
+        }
+    }
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useCesarBatch() {
+    std::cout << "--- DEMOSTRACIÓN DE CÉSAR POR LOTES ---" << std::endl;
+
+    // Genera un archivo con un millón de líneas cifradas con claves aleatorias.
+    const std::vector<std::string> mensajes = {
+        "el envio llegara manana por la tarde", "la reunion se cambia al jueves a las diez",
+        "no olvides traer los documentos firmados", "el servidor principal vuelve a estar en linea"};
+    CesarEncryption cesar;
+    std::mt19937 rng(7);
+    {
+        std::ofstream entrada("cesar_lote_entrada.txt", std::ios::binary);
+        for (int i = 0; i < 1000000; ++i) {
+            entrada << cesar.encode(mensajes[i % mensajes.size()], static_cast<int>(rng() % 26)) << '\n';
+        }
+    }
+
+    CesarBatchCracker cracker;
+    CesarBatchStats stats = cracker.run("cesar_lote_entrada.txt", "cesar_lote_salida.txt");
+    std::cout << stats.lines << " lineas (" << stats.bytes / (1024.0 * 1024.0) << " MB) en " << stats.seconds
+        << " s: " << stats.lines / stats.seconds / 1e6 << " millones de lineas/s" << std::endl;
+
+    std::ifstream salida("cesar_lote_salida.txt");
+    std::string linea;
+    for (int i = 0; i < 3 && std::getline(salida, linea); ++i) {
+        std::cout << "  " << linea << std::endl;
+    }
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+void
+useScoreCache() {
+    std::cout << "--- DEMOSTRACIÓN DE LA CACHÉ DE PUNTUACIONES ---" << std::endl;
+
+    // Con archivo asociado, las puntuaciones sobreviven entre ejecuciones.
+    ScoreCache& cache = ScoreCache::shared();
+    try {
+        cache.attachFile("cache_congruencia.bin");
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+    std::cout << "Puntuaciones cargadas del disco: " << cache.size() << std::endl;
+
+    CesarEncryption cesar;
+    std::string cifrado = cesar.encode("Pero eso esperaba bajo la lluvia", 11);
+    std::vector<std::string> textos;
+    std::vector<std::string> ids;
+    for (int clave = 0; clave < 26; ++clave) {
+        textos.push_back(cesar.decode(cifrado, clave));
+        ids.push_back("Clave " + std::to_string(clave));
+    }
+
+    EvaluationIA evaluador;
+    for (int ronda = 1; ronda <= 2; ++ronda) {
+        uint64_t misses_antes = cache.misses();
+        auto inicio = std::chrono::steady_clock::now();
+        evaluador.evaluate_and_print_top_three(textos, ids);
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        std::cout << "Ronda " << ronda << ": " << cache.misses() - misses_antes << " textos enviados a la API, "
+            << segundos << " s" << std::endl;
+    }
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+/**
+ * @brief Demostración de evaluate(): las puntuaciones se muestran según llegan y al final
+ * se obtienen los 5 mejores candidatos, referidos por su índice.
+ */
+void
+useStreamingTopK() {
+    std::cout << "--- DEMOSTRACIÓN DE EVALUACIÓN INCREMENTAL (TOP-K) ---" << std::endl;
+
+    CesarEncryption cesar;
+    std::string cifrado = cesar.encode("Pero eso esperaba bajo la lluvia", 11);
+    std::vector<std::string> textos;
+    for (int clave = 0; clave < 26; ++clave) {
+        textos.push_back(cesar.decode(cifrado, clave));
+    }
+
+    EvaluationIA evaluador;
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<ScoredCandidate> mejores = evaluador.evaluate(textos, 5, [&](const ScoredCandidate& resultado) {
+        if (resultado.congruence_score >= EvaluationIA::MAX_SCORE) {
+            double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+            std::cout << "Candidato perfecto (clave " << resultado.index << ") tras " << segundos << " s" << std::endl;
+        }
+    });
+
+    std::cout << "Top " << mejores.size() << ":" << std::endl;
+    for (const ScoredCandidate& candidato : mejores) {
+        std::cout << "  Clave " << candidato.index << ": " << candidato.congruence_score
+            << " \"" << textos[candidato.index] << "\"" << std::endl;
+    }
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+/**
+ * @brief Demostración de la tubería con corrutinas: el descifrado local de cada mensaje se solapa
+ * con la evaluación remota de los anteriores.
+ */
+void
+useScoringPipeline() {
+    std::cout << "--- DEMOSTRACIÓN DE LA TUBERÍA DE EVALUACIÓN ---" << std::endl;
+
+    const std::vector<std::string> mensajes = {
+        "el envio llegara manana por la tarde", "la reunion se cambia al jueves a las diez",
+        "no olvides traer los documentos firmados", "el servidor principal vuelve a estar en linea"};
+    CesarEncryption cesar;
+    std::mt19937 rng(7);
+    std::vector<std::string> cifrados;
+    for (int i = 0; i < 40; ++i) {
+        cifrados.push_back(cesar.encode(mensajes[i % mensajes.size()] + " " + std::to_string(i),
+                                        static_cast<int>(rng() % 26)));
+    }
+
+    EvaluationIA evaluador;
+    ScoringPipeline tuberia(evaluador, 1);
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<PipelineResult> resultados = tuberia.run(CesarEncryption::candidateSets(cifrados));
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    for (size_t i = 0; i < resultados.size() && i < 5; ++i) {
+        const PipelineResult& resultado = resultados[i];
+        if (resultado.best.empty()) {
+            std::cout << "  Mensaje " << resultado.message << ": sin resultados de la API" << std::endl;
+            continue;
+        }
+        const ScoredCandidate& mejor = resultado.best.front();
+        std::cout << "  Mensaje " << resultado.message << ": clave " << mejor.index << ", \""
+            << resultado.candidates[mejor.index] << "\"" << std::endl;
+    }
+    std::cout << resultados.size() << " mensajes en " << segundos << " s" << std::endl;
+
+    std::cout << "\n--- FIN DE LA DEMOSTRACIÓN ---" << std::endl;
+}
+
+/**
+ * @brief Herramienta de entrenamiento del modelo de n-gramas:
+ * --entrenar-ngramas <corpus> <salida> [orden]
+ * @return El código de salida del proceso.
+ */
+int
+trainNGramTool(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " --entrenar-ngramas <corpus> <salida> [orden 2-4]" << std::endl;
+        return 1;
+    }
+    int order = argc > 4 ? std::atoi(argv[4]) : 4;
+    try {
+        uint64_t ngrams = NGramModel::train(argv[2], argv[3], order);
+        std::cout << "Modelo de orden " << order << " guardado en '" << argv[3] << "' (" << ngrams
+            << " n-gramas)." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Criptoanálisis César por lotes: --cesar-lote <entrada|-> <salida|-> [hilos]
+ * @return El código de salida del proceso.
+ */
 int
-main() {
+cesarBatchTool(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " --cesar-lote <entrada|-> <salida|-> [hilos]" << std::endl;
+        return 1;
+    }
+    unsigned int threads = argc > 4 ? static_cast<unsigned int>(std::atoi(argv[4])) : 0;
+    try {
+        CesarBatchStats stats = CesarBatchCracker(threads).run(argv[2], argv[3]);
+        std::cerr << stats.lines << " lineas procesadas en " << stats.seconds << " s." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int
+main(int argc, char* argv[]) {
     constexpr bool local = false;
 
+    if (argc > 1 && std::string(argv[1]) == "--entrenar-ngramas") {
+        return trainNGramTool(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--cesar-lote") {
+        return cesarBatchTool(argc, argv);
+    }
+
     //useCesar(local);
     //useXOR();
     useAscii();
+    //useDesKeySearch();
+    //useTripleDes();
+    //useDoubleDesMeetInTheMiddle();
+    //useDesRainbowTable();
+    //useDesDifferential();
+    //useDesLinear();
+    //useNGramModel();
+    //useVigenere();
+    //useSubstitution();
+    //useMonoalphabeticFamilies();
+    //useCesarBatch();
+    //useScoreCache();
+    //useStreamingTopK();
+    //useScoringPipeline();
 
     return 0;
 }
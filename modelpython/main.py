@@ -1,13 +1,36 @@
-﻿import math
+﻿import json
+import math
+from typing import Any, Dict, List, Optional, Type, TypeVar, Union
+
+import cbor2
+import msgpack
 import torch
-from fastapi import FastAPI, HTTPException
-from pydantic import BaseModel
+from fastapi import FastAPI, HTTPException, Request, Response
+from fastapi.concurrency import run_in_threadpool
+from fastapi.encoders import jsonable_encoder
+from pydantic import BaseModel, ValidationError
 from transformers import AutoTokenizer, AutoModelForCausalLM
 
 # --- Configuración del Modelo y Puntuación ---
 MODEL_NAME = "PlanTL-GOB-ES/gpt2-base-bne"
 PPL_TARGET_FOR_SCORE_10 = 30.0
 PPL_FLOOR_FOR_SCORE_1 = 700.0
+MAX_TOKENS = 512
+BATCH_SIZE = 32  # textos por pasada del modelo en el endpoint por lotes
+# Formatos admitidos en el cuerpo de peticiones y respuestas (negociados con Content-Type y Accept).
+MEDIA_JSON = "application/json"
+MEDIA_CBOR = "application/cbor"
+MEDIA_MSGPACK = "application/msgpack"
+BINARY_DECODERS = {
+    MEDIA_CBOR: cbor2.loads,
+    MEDIA_MSGPACK: lambda body: msgpack.unpackb(body, raw=False),
+    "application/x-msgpack": lambda body: msgpack.unpackb(body, raw=False),
+}
+BINARY_ENCODERS = {
+    MEDIA_CBOR: cbor2.dumps,
+    MEDIA_MSGPACK: msgpack.packb,
+    "application/x-msgpack": msgpack.packb,
+}
 tokenizer = None
 model = None
 
@@ -27,6 +50,9 @@ async def load_model_on_startup():
     print(f"🚀 Iniciando la carga del modelo: {MODEL_NAME}...")
     try:
         tokenizer = AutoTokenizer.from_pretrained(MODEL_NAME)
+        if tokenizer.pad_token is None:
+            # GPT-2 no tiene token de relleno; el relleno se enmascara al calcular la pérdida.
+            tokenizer.pad_token = tokenizer.eos_token
         model = AutoModelForCausalLM.from_pretrained(MODEL_NAME)
         model.eval()
         print("✅ Modelo y tokenizador cargados exitosamente.")
@@ -41,12 +67,23 @@ class TextInput(BaseModel):
     texto: str
 
 
+class TextBatchInput(BaseModel):
+    textos: List[str]
+
+
 class CongruenceResponse(BaseModel):
     texto_evaluado: str
     puntuacion_congruencia: float
     perplejidad_calculada: float
 
 
+class CongruenceBatchResponse(BaseModel):
+    resultados: List[CongruenceResponse]
+
+
+PayloadModel = TypeVar("PayloadModel", bound=BaseModel)
+
+
 # --- Funciones Auxiliares ---
 def calculate_perplexity(text_to_evaluate: str, model_loaded, tokenizer_loaded) -> float:
     """Calcula la perplejidad de un texto dado."""
@@ -54,7 +91,7 @@ def calculate_perplexity(text_to_evaluate: str, model_loaded, tokenizer_loaded)
         return float('inf')
 
     try:
-        inputs = tokenizer_loaded(text_to_evaluate, return_tensors="pt", max_length=512, truncation=True)
+        inputs = tokenizer_loaded(text_to_evaluate, return_tensors="pt", max_length=MAX_TOKENS, truncation=True)
         input_ids = inputs.input_ids
 
         if input_ids.size(1) == 0:
@@ -71,6 +108,49 @@ def calculate_perplexity(text_to_evaluate: str, model_loaded, tokenizer_loaded)
         return float('inf')
 
 
+def calculate_perplexities(texts: List[str], model_loaded, tokenizer_loaded) -> List[float]:
+    """Calcula la perplejidad de varios textos con una sola pasada del modelo (entrada rellenada)."""
+    perplexities = [float('inf')] * len(texts)
+    valid = [i for i, text in enumerate(texts) if text.strip()]
+    if not valid:
+        return perplexities
+
+    try:
+        inputs = tokenizer_loaded([texts[i] for i in valid], return_tensors="pt", padding=True,
+                                  max_length=MAX_TOKENS, truncation=True)
+        input_ids = inputs.input_ids
+        attention_mask = inputs.attention_mask
+
+        with torch.no_grad():
+            logits = model_loaded(input_ids, attention_mask=attention_mask).logits
+
+        # Pérdida por token (predicción del siguiente), ignorando las posiciones de relleno.
+        shift_logits = logits[:, :-1, :]
+        shift_labels = input_ids[:, 1:]
+        shift_mask = attention_mask[:, 1:].to(shift_logits.dtype)
+        token_loss = torch.nn.functional.cross_entropy(
+            shift_logits.transpose(1, 2), shift_labels, reduction="none")
+        token_counts = shift_mask.sum(dim=1)
+        sample_loss = (token_loss * shift_mask).sum(dim=1) / token_counts.clamp(min=1)
+
+        for row, index in enumerate(valid):
+            if token_counts[row].item() > 0:
+                perplexities[index] = torch.exp(sample_loss[row]).item()
+    except Exception as e:
+        print(f"⚠️ Error calculando perplejidad por lotes ({len(valid)} textos): {e}")
+    return perplexities
+
+
+def build_response(text: str, perplexity: float) -> CongruenceResponse:
+    """Construye la respuesta de un texto a partir de su perplejidad."""
+    return CongruenceResponse(
+        texto_evaluado=text,
+        puntuacion_congruencia=convert_perplexity_to_score(perplexity),
+        perplejidad_calculada=round(perplexity, 2) if not (
+                math.isinf(perplexity) or math.isnan(perplexity)) else -1.0
+    )
+
+
 def convert_perplexity_to_score(ppl: float) -> float:
     """Convierte la perplejidad a una puntuación de 1.0 a 10.0."""
     if math.isinf(ppl) or math.isnan(ppl) or ppl >= PPL_FLOOR_FOR_SCORE_1:
@@ -89,12 +169,106 @@ def convert_perplexity_to_score(ppl: float) -> float:
     return round(max(1.0, min(10.0, score)), 2)
 
 
+async def read_payload(request: Request, payload_class: Type[PayloadModel]) -> PayloadModel:
+    """Lee el cuerpo en JSON, CBOR o MessagePack según su Content-Type y lo valida con Pydantic."""
+    media_type = request.headers.get("content-type", MEDIA_JSON).split(";")[0].strip().lower()
+    body = await request.body()
+    try:
+        if media_type in BINARY_DECODERS:
+            data = BINARY_DECODERS[media_type](body)
+        elif media_type in (MEDIA_JSON, ""):
+            data = json.loads(body)
+        else:
+            raise HTTPException(status_code=415, detail=f"Formato no admitido: '{media_type}'.")
+        return payload_class.model_validate(data)
+    except HTTPException:
+        raise
+    except ValidationError as e:
+        raise HTTPException(status_code=422, detail=e.errors(include_url=False))
+    except Exception as e:
+        raise HTTPException(status_code=400, detail=f"Cuerpo '{media_type}' no válido: {e}")
+
+
+def evaluate_text(texto: str) -> CongruenceResponse:
+    """Evalúa un texto; bloquea durante la inferencia, así que se ejecuta fuera del bucle de eventos."""
+    print(f"💬 Evaluando congruencia para: '{texto}'")
+
+    perplexity_calculada = calculate_perplexity(texto, model, tokenizer)
+    puntuacion = convert_perplexity_to_score(perplexity_calculada)
+
+    print(f"Perplejidad: {perplexity_calculada:.2f}, Puntuación 1-10: {puntuacion}")
+
+    return CongruenceResponse(
+        texto_evaluado=texto,
+        puntuacion_congruencia=puntuacion,
+        perplejidad_calculada=round(perplexity_calculada, 2) if not (
+                    math.isinf(perplexity_calculada) or math.isnan(perplexity_calculada)) else -1.0
+    )
+
+
+def evaluate_batch(textos: List[str]) -> CongruenceBatchResponse:
+    """Evalúa un lote en pasadas de hasta BATCH_SIZE textos; también se ejecuta fuera del bucle de eventos."""
+    print(f"💬 Evaluando congruencia por lotes: {len(textos)} textos")
+
+    resultados = []
+    for start in range(0, len(textos), BATCH_SIZE):
+        parte = textos[start:start + BATCH_SIZE]
+        perplexities = calculate_perplexities(parte, model, tokenizer)
+        resultados.extend(build_response(texto, ppl) for texto, ppl in zip(parte, perplexities))
+    return CongruenceBatchResponse(resultados=resultados)
+
+
+def encode_response(request: Request, payload: Union[BaseModel, Dict[str, Any]], status_code: int = 200,
+                    headers: Optional[Dict[str, str]] = None) -> Response:
+    """Serializa la respuesta en el primer formato binario de la cabecera Accept, o en JSON."""
+    data = payload.model_dump() if isinstance(payload, BaseModel) else payload
+    for accepted in request.headers.get("accept", "").split(","):
+        media_type = accepted.split(";")[0].strip().lower()
+        if media_type in BINARY_ENCODERS:
+            return Response(content=BINARY_ENCODERS[media_type](data), status_code=status_code, headers=headers,
+                            media_type=media_type)
+        if media_type in (MEDIA_JSON, "*/*"):
+            break
+    content = payload.model_dump_json() if isinstance(payload, BaseModel) else json.dumps(data)
+    return Response(content=content, status_code=status_code, headers=headers, media_type=MEDIA_JSON)
+
+
+def request_body_schema(payload_class: Type[BaseModel]) -> Dict[str, Any]:
+    """Documenta en OpenAPI el cuerpo que read_payload valida, en los tres formatos admitidos."""
+    schema = payload_class.model_json_schema()
+    return {
+        "requestBody": {
+            "required": True,
+            "content": {media_type: {"schema": schema} for media_type in (MEDIA_JSON, MEDIA_CBOR, MEDIA_MSGPACK)},
+        }
+    }
+
+
+@app.middleware("http")
+async def advertise_body_formats(request: Request, call_next):
+    """Anuncia en Accept-Post los formatos de cuerpo admitidos; el cliente solo pasa a CBOR si los ve."""
+    response = await call_next(request)
+    response.headers["Accept-Post"] = ", ".join((MEDIA_JSON, MEDIA_CBOR, MEDIA_MSGPACK))
+    return response
+
+
+@app.exception_handler(HTTPException)
+async def http_exception_in_requested_format(request: Request, exc: HTTPException):
+    """
+    Devuelve los errores en el formato pedido en Accept. Así el cliente distingue un error de validación
+    (que llega en su formato binario) de un servidor antiguo que no entiende ese formato (responde en JSON).
+    """
+    return encode_response(request, {"detail": jsonable_encoder(exc.detail)}, exc.status_code, getattr(exc, "headers", None))
+
+
 # --- Endpoints de la API ---
-@app.post("/evaluar_congruencia/", response_model=CongruenceResponse)
-async def evaluar_congruencia_texto(item: TextInput):
+@app.post("/evaluar_congruencia/", response_model=CongruenceResponse, openapi_extra=request_body_schema(TextInput))
+async def evaluar_congruencia_texto(request: Request):
     """
     Recibe un texto en español y devuelve una puntuación de congruencia (1-10).
+    El cuerpo puede ir en JSON, CBOR o MessagePack; la respuesta usa el formato pedido en Accept.
     """
+    item = await read_payload(request, TextInput)
     if model is None or tokenizer is None:
         raise HTTPException(status_code=503,
                             detail="El modelo de IA no está disponible o no se pudo cargar. Inténtalo más tarde.")
@@ -102,19 +276,25 @@ async def evaluar_congruencia_texto(item: TextInput):
     if not item.texto or not item.texto.strip():
         raise HTTPException(status_code=400, detail="El campo 'texto' no puede estar vacío.")
 
-    print(f"💬 Evaluando congruencia para: '{item.texto}'")
+    # La inferencia va al grupo de hilos de FastAPI (torch libera el GIL): el bucle de eventos sigue
+    # atendiendo otras peticiones y las comprobaciones de salud mientras el modelo trabaja.
+    return encode_response(request, await run_in_threadpool(evaluate_text, item.texto))
 
-    perplexity_calculada = calculate_perplexity(item.texto, model, tokenizer)
-    puntuacion = convert_perplexity_to_score(perplexity_calculada)
 
-    print(f"Perplejidad: {perplexity_calculada:.2f}, Puntuación 1-10: {puntuacion}")
+@app.post("/evaluar_congruencia_lote/", response_model=CongruenceBatchResponse,
+          openapi_extra=request_body_schema(TextBatchInput))
+async def evaluar_congruencia_lote(request: Request):
+    """
+    Recibe una lista de textos y devuelve la puntuación de cada uno, en el mismo orden.
+    Los textos se evalúan en pasadas rellenadas de hasta BATCH_SIZE textos; los vacíos reciben 1.0.
+    Con CBOR o MessagePack los lotes grandes ocupan menos y se serializan más rápido que en JSON.
+    """
+    item = await read_payload(request, TextBatchInput)
+    if model is None or tokenizer is None:
+        raise HTTPException(status_code=503,
+                            detail="El modelo de IA no está disponible o no se pudo cargar. Inténtalo más tarde.")
 
-    return CongruenceResponse(
-        texto_evaluado=item.texto,
-        puntuacion_congruencia=puntuacion,
-        perplejidad_calculada=round(perplexity_calculada, 2) if not (
-                    math.isinf(perplexity_calculada) or math.isnan(perplexity_calculada)) else -1.0
-    )
+    return encode_response(request, await run_in_threadpool(evaluate_batch, item.textos))
 
 
 @app.get("/")